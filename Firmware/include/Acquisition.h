@@ -0,0 +1,73 @@
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <Arduino.h>
+#include <Adafruit_ADXL345_U.h>
+
+// Accelerometer acquisition layer.
+//
+// With ACQ_OVERSAMPLE set, the ADXL345 runs at 200 Hz in FIFO stream mode.
+// Every loop the FIFO is drained and each axis goes through a 3rd order
+// integer CIC decimator (R = 4), so the detector still sees 50 Hz samples
+// but content above 25 Hz is filtered instead of aliased into the 3-7 Hz
+// bands. The CIC costs 3 integrator adds per axis per input sample plus
+// 3 comb subtractions per output sample, and its nulls sit on
+// 50/100/150 Hz, exactly where aliases would land.
+//
+// The FIFO holds 32 entries (160 ms at 200 Hz). If the loop stalls longer
+// than that, stream mode silently drops samples; a full FIFO is treated
+// as an overrun that flushes the sensor, resets the CIC and drops the
+// history, since it would span the gap.
+//
+// With ACQ_OVERSAMPLE cleared, one sample is read every 20 ms as before.
+//
+// Decimated samples are kept as int16 magnitudes (raw counts with
+// ACQ_FRAC_BITS of extra resolution) in a history ring that always holds
+// the last ACQ_HISTORY_LEN samples. The main loop reads new samples from
+// it, and on a motion trigger can rewind into it so the capture window
+// starts with the motion onset instead of after it.
+
+#define ACQ_OVERSAMPLE       1
+
+#define ACQ_OUTPUT_RATE_HZ   50     // Rate seen by the FFT / detector
+#define ACQ_SAMPLE_PERIOD_MS (1000 / ACQ_OUTPUT_RATE_HZ)
+
+#if ACQ_OVERSAMPLE
+#define ACQ_DATARATE         ADXL345_DATARATE_200_HZ
+#define ACQ_DECIMATION       4
+#define ACQ_CIC_ORDER        3
+#define ACQ_CIC_GAIN_BITS    6      // log2(ACQ_DECIMATION ^ ACQ_CIC_ORDER)
+#define ACQ_FIFO_DEPTH       32
+#else
+#define ACQ_DATARATE         ADXL345_DATARATE_50_HZ
+#endif
+
+#define ACQ_FRAC_BITS        4      // Sub-count bits kept after decimation
+#define ACQ_HISTORY_LEN      64     // 1.28 s of pre-trigger history, 128 bytes
+#define ACQ_I2C_CLOCK_HZ     400000 // A FIFO entry takes ~1 ms at 100 kHz
+
+// Single-register access to the ADXL345 (at ADXL345_DEFAULT_ADDRESS)
+void accelWriteRegister(uint8_t reg, uint8_t value);
+uint8_t accelReadRegister(uint8_t reg);
+
+// Configures the FIFO; call after the sensor range/data rate are set
+void acquisitionBegin();
+
+// Drains the sensor and returns how many new samples were queued
+uint8_t acquisitionPoll();
+
+// Makes the last `samples` (up to what has been recorded) readable again;
+// returns how many will be replayed before new samples
+uint8_t acquisitionRewind(uint8_t samples);
+
+// Pops the oldest unread sample as gravity-removed magnitude in m/s^2
+bool acquisitionRead(float &sample);
+
+// FIFO overruns since boot; a change means samples were lost and any
+// capture in progress no longer joins up with what follows
+uint16_t acquisitionOverruns();
+
+// Most recent sample, same units as acquisitionRead()
+float acquisitionLatest();
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+
+// Persistent episode log kept in the 32u4's 1 KB EEPROM, or in the last
+// two 8 KB erase blocks of internal flash on the Feather M4.
+//
+// The log is a ring of fixed 5-byte records:
+//   [0]    sequence number (0..254, 0xFF = erased slot)
+//   [1]    event type (top 2 bits) | peak frequency (low 6 bits, see
+//          eventLogEncodeFrequency)
+//   [2]    peak amplitude, log2 encoded (see eventLogEncodeAmplitude)
+//   [3..4] seconds since the previous record, little endian, saturating
+//
+// The peak is stored in Hz rather than as an FFT bin, so the log reads
+// the same whatever FFT size or zoom setting wrote it. A BOOT record
+// carries EVENTLOG_DUMP_VERSION in its amplitude byte, which tells the
+// decoder which record format the entries after it use (version 1
+// firmware stored FFT bins and wrote 0 there).
+//
+// Appends always go to the slot after the newest record, so writes are
+// spread evenly over the whole EEPROM and no record is ever rewritten
+// until the ring wraps. The newest record is found at boot by scanning
+// for the break in the sequence numbers.
+//
+// In flash each record takes one 16-byte quad-word, the smallest unit the
+// SAMD51 programs, so an append touches only its own slot. A block is
+// erased when the ring enters it, i.e. once every 512 appends.
+
+#define EVENTLOG_RECORD_SIZE  5
+#if defined(__AVR__)
+#define EVENTLOG_BASE         0      // First EEPROM byte used by the log
+#define EVENTLOG_SLOTS        204    // 204 * 5 = 1020 bytes
+#else
+#define EVENTLOG_FLASH_BLOCK_SIZE 8192  // SAMD51 erase unit
+#define EVENTLOG_FLASH_BLOCKS     2
+#define EVENTLOG_FLASH_STRIDE     16    // One quad-word per record
+#define EVENTLOG_SLOTS_PER_BLOCK  (EVENTLOG_FLASH_BLOCK_SIZE / EVENTLOG_FLASH_STRIDE)
+#define EVENTLOG_SLOTS            (EVENTLOG_FLASH_BLOCKS * EVENTLOG_SLOTS_PER_BLOCK)
+#endif
+// EVENTLOG_SLOTS must not be a multiple of EVENTLOG_SEQ_MODULO, or a full
+// ring would have no sequence break
+#define EVENTLOG_SEQ_MODULO   255    // 0xFF is reserved for erased slots
+#define EVENTLOG_SEQ_ERASED   0xFF
+#define EVENTLOG_NO_HEAD      0xFFFF
+
+#define EVENTLOG_DUMP_VERSION 2
+
+#define EVENTLOG_FREQ_STEP_HZ 0.25f  // Peak frequency units in byte 1
+#define EVENTLOG_FREQ_MAX     62     // Measured peaks saturate at 15.5 Hz
+#define EVENTLOG_FREQ_NONE    0      // No spectral peak measured
+#define EVENTLOG_FREQ_EARLY   63     // Sequential early decision, no spectrum
+
+// Event types stored in the top two bits of byte 1
+enum EventType {
+    EVENT_BOOT       = 0,  // Device reset; restarts the time base
+    EVENT_TREMOR     = 1,
+    EVENT_DYSKINESIA = 2,
+    EVENT_CLEAR      = 3,  // Detections went back to normal
+};
+
+// Finds the newest record and appends a boot marker
+void eventLogBegin();
+
+// Appends one record; peakCode comes from eventLogEncodeFrequency
+void eventLogAppend(EventType type, uint8_t peakCode, float peakAmplitude);
+
+// Writes the whole ring as one binary frame (see tools/eventlog_decode.py)
+void eventLogDump(Stream &out);
+
+// Marks every slot as erased
+void eventLogErase();
+
+uint8_t eventLogEncodeAmplitude(float amplitude);
+
+// Quarter-Hz steps; any measured peak codes as 1..EVENTLOG_FREQ_MAX
+uint8_t eventLogEncodeFrequency(float peakHz);
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef SENSOR_CHANNEL_H
+#define SENSOR_CHANNEL_H
+
+#include <Arduino.h>
+
+// Data structure for sharing sensor detection data
+// between P team (detection algorithms) and U team (UI)
+struct SensorData {
+    float magnitude;           // Single magnitude value from sensor
+    bool tremorDetected;       // Whether tremor is detected
+    bool dyskinesiaDetected;   // Whether dyskinesia is detected
+    unsigned long timestamp;   // Timestamp of detection
+};
+
+// Snapshot channel: the writer fills the spare copy of SensorData and then
+// publishes it, bumping a sequence number. Readers copy the published
+// side and retry if a publish happened meanwhile, so they never see a
+// half-updated struct and the writer never waits, even when it is an
+// ISR. There must be a single writer.
+void publishSensorData(const SensorData &data);
+void readSensorSnapshot(SensorData &out);
+
+// UI event queue. Producers post what happened; the UI loop pops events
+// and redraws only what they affect.
+enum UiEventType {
+    UI_EVENT_STATE_CHANGED,    // Tremor or dyskinesia flag flipped
+    UI_EVENT_NEW_SAMPLE,       // New magnitude for the graph (rate limited)
+    UI_EVENT_NEW_SPECTRUM,     // Capture ended; a = peak freq in 0.1 Hz, or
+                               // UI_PEAK_NONE if it ended without a spectrum
+    UI_EVENT_TOUCH,            // Screen tapped at (a, b)
+};
+
+struct UiEvent {
+    uint8_t type;
+    int16_t a;
+    int16_t b;
+};
+
+#define UI_EVENT_QUEUE_LEN 8     // Power of two
+#define UI_PEAK_NONE       -1
+
+// Returns false (and drops the event) when the queue is full
+bool postUiEvent(uint8_t type, int16_t a = 0, int16_t b = 0);
+bool popUiEvent(UiEvent &event);
+
+#endif
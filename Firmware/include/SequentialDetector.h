@@ -0,0 +1,58 @@
+#ifndef SEQUENTIAL_DETECTOR_H
+#define SEQUENTIAL_DETECTOR_H
+
+#include <Arduino.h>
+#include "Acquisition.h"
+
+// Sample-by-sample early decision detector.
+//
+// Each sample is DC-blocked and passed through two biquad band-pass
+// filters (tremor 3-5 Hz, dyskinesia 5-7 Hz). For each band a Wald
+// sequential probability ratio test accumulates the log-likelihood that
+// the band holds SEQ_RATIO_H1 of the total signal power (symptom) rather
+// than SEQ_RATIO_H0 (background motion). When a band's evidence crosses
+// the upper threshold it is declared; when both bands cross the lower
+// threshold the capture is declared clear. Cost is about 14 multiplies
+// and one divide per sample.
+
+#define SEQ_SAMPLE_RATE_HZ   ((float)ACQ_OUTPUT_RATE_HZ)
+
+#define SEQ_TREMOR_CENTER_HZ 4.0f
+#define SEQ_TREMOR_Q         2.0f     // 2 Hz bandwidth
+#define SEQ_DYSK_CENTER_HZ   6.0f
+#define SEQ_DYSK_Q           3.0f     // 2 Hz bandwidth
+
+#define SEQ_RATIO_H0         0.15f    // Band share of power with no symptom
+#define SEQ_RATIO_H1         0.60f    // Band share of power with a symptom
+
+// Samples of a narrowband signal are far from independent; scale the
+// per-sample evidence by roughly (2 * bandwidth / sample rate)
+#define SEQ_EVIDENCE_SCALE   0.10f
+
+// Wald thresholds for 1% false alarm and 1% miss rates: +-ln(99)
+#define SEQ_THRESHOLD_UPPER  4.6f
+#define SEQ_THRESHOLD_LOWER  -4.6f
+
+// Below this smoothed power ((m/s^2)^2) the hand is still, which counts
+// as evidence against both symptoms
+#define SEQ_QUIET_POWER      0.1f
+#define SEQ_QUIET_EVIDENCE   -0.2f
+
+#define SEQ_WARMUP_SAMPLES   12       // Let the filters settle first
+
+enum SequentialDecision {
+    SEQ_UNDECIDED,
+    SEQ_TREMOR,
+    SEQ_DYSKINESIA,
+    SEQ_CLEAR,
+};
+
+// Clears filter state and evidence; call at the start of each capture.
+// The first primingSamples updates (pre-trigger history) only settle the
+// filters and the power estimate; evidence is scored from the trigger on.
+void sequentialDetectorReset(uint8_t primingSamples = 0);
+
+// Feeds one gravity-removed magnitude sample (m/s^2)
+SequentialDecision sequentialDetectorUpdate(float sample);
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <Arduino.h>
+#include "Acquisition.h"
+
+// Magnitude spectrum backend shared by both build targets.
+//
+// The 32u4 uses ArduinoFFT. On the SAMD51 (Feather M4) the same call goes
+// to CMSIS-DSP's arm_rfft_fast_f32 / arm_cmplx_mag_f32, which use the FPU
+// and a real-input FFT of half the size. Both apply the same Hamming
+// window and return the same unnormalised magnitudes, so detector code
+// does not care which one ran.
+
+#if defined(__SAMD51__)
+#define SPECTRUM_USE_CMSIS 1
+#define SPECTRUM_BACKEND   "cmsis"
+#else
+#define SPECTRUM_USE_CMSIS 0
+#define SPECTRUM_BACKEND   "arduinofft"
+#endif
+
+/* ================= FFT config ================= */
+// 64 points = 1.28 s window, 0.78 Hz bins. Peak interpolation recovers
+// the precision of the old 128-point window at half the latency and cost.
+#define FFT_SIZE               64
+#define FFT_SAMPLING_FREQUENCY ACQ_OUTPUT_RATE_HZ
+#define FFT_BIN_HZ             ((float)FFT_SAMPLING_FREQUENCY / FFT_SIZE)
+
+/* ================= Feature config ================= */
+// Energy below this is left out of the band ratios (drift, posture)
+#define BAND_TOTAL_MIN_HZ      1.0f
+// Head start for bins below LOW_BIN_MAX_HZ so slow movement doesn't win
+// the peak search. Tuned as 5 at 128 points; magnitudes scale with
+// FFT_SIZE.
+#define LOW_BIN_BIAS           (5.0f * FFT_SIZE / 128)
+#define LOW_BIN_MAX_HZ         1.0f
+
+/* ================= Shared filters ================= */
+#define DC_BLOCK_POLE          0.94f  // ~0.5 Hz high-pass corner at 50 Hz
+
+// One-pole DC blocker, used ahead of both the zoom mixer and the
+// sequential detector's band-pass filters
+struct DcBlocker {
+    float prevInput;
+    float output;
+    bool primed;
+};
+
+// Detector features of one magnitude spectrum
+struct SpectrumFeatures {
+    float peakFreq;           // Interpolated, Hz; 0 if no bin beat the floor
+    float peakAmp;            // Magnitude of the peak bin
+    float tremorRatio;        // Share of >= BAND_TOTAL_MIN_HZ energy in [3, 5) Hz
+    float dyskinesiaRatio;    // Same for [5, 7) Hz
+};
+
+// Windows `samples` (FFT_SIZE values) in place and replaces them with the
+// magnitude spectrum. Bins FFT_SIZE/2.. mirror the lower half, as a full
+// complex FFT of real input would give.
+void computeMagnitudeSpectrum(float samples[]);
+
+// Hamming window coefficient i of n, as ArduinoFFT's FFT_WIN_TYP_HAMMING
+float hammingWindow(int i, int n);
+
+void dcBlockerReset(DcBlocker &filter);
+
+// The first sample after a reset primes the filter instead of producing
+// a step
+float dcBlockerStep(DcBlocker &filter, float sample);
+
+// Fractional bin offset (-0.5..0.5) of a spectral peak from its neighbours
+float interpolatePeakOffset(float left, float center, float right);
+
+// Three quarters of the mean of `count` magnitudes, in the integer
+// arithmetic the detector was tuned with; removed before the peak search
+int spectrumFloor(const float mag[], int count);
+
+// Extracts the detector features from `bins` magnitudes in ascending
+// frequency order, bin k being firstHz + k * binHz. The peak bin is picked
+// in [searchLowHz, searchHighHz) on weighted scores (floor removed, 3-5 Hz
+// favoured over 5-7 Hz, sub-1 Hz biased up), then interpolated on the
+// unweighted magnitudes.
+void extractSpectrumFeatures(const float mag[], int bins, float firstHz, float binHz,
+                             float searchLowHz, float searchHighHz, int floor,
+                             SpectrumFeatures &features);
+
+// Times computeMagnitudeSpectrum() on a synthetic 4 Hz signal and returns
+// the average microseconds per frame; `scratch` needs FFT_SIZE floats
+unsigned long benchmarkSpectrum(float scratch[], uint16_t frames);
+
+#endif
@@ -5,20 +5,13 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_ILI9341.h>
 #include <Adafruit_TSC2007.h>
-
-// Data structure for sharing sensor detection data
-// between P team (detection algorithms) and U team (UI)
-struct SensorData {
-    float magnitude;           // Single magnitude value from sensor
-    bool tremorDetected;       // Whether tremor is detected
-    bool dyskinesiaDetected;   // Whether dyskinesia is detected
-    unsigned long timestamp;   // Timestamp of detection
-};
+#include "SensorChannel.h"
 
 // TFT Display pins (for Feather 32u4 with TFT FeatherWing)
 #define TFT_CS   9
 #define TFT_DC   10
 #define TFT_RST  -1  // RST can be set to -1 if sharing Arduino reset pin
+#define TFT_SPI_FREQ_SAMD51 24000000  // Feather M4 only; the 32u4 uses SPI_CLOCK_DIV2
 
 // Screen states enum
 enum Screen {
@@ -31,11 +24,11 @@ enum Screen {
 #define TOUCH_COOLDOWN_MS 300  // Cooldown period after processing a touch
 #define MIN_TOUCH_DURATION_MS 50  // Minimum touch duration to be considered valid (ignore noise)
 #define MIN_SWIPE_MOVEMENT 5  // Minimum pixel movement to consider it a swipe (not just a tap)
+#define GRAPH_SAMPLE_PERIOD_MS 100  // Rate of UI_EVENT_NEW_SAMPLE, one graph pixel each
 
 // Extern declarations for global variables accessed by UI functions
 extern Adafruit_ILI9341 tft;
 extern Adafruit_TSC2007 ts;
-extern SensorData sensorData;
 extern Screen currentScreen;
 extern bool graphScreenDrawn;
 extern unsigned long screenInactivityStart;
@@ -55,8 +48,6 @@ extern bool touchActive;
 extern bool touchscreenAvailable;
 extern bool touchJustEnded;
 extern unsigned long lastTouchProcessTime;
-extern bool tremorDataChanged;
-extern bool dyskinesiaDataChanged;
 
 // Color definitions (needed for UI functions)
 #define BLACK    0x0000
@@ -74,14 +65,16 @@ extern bool dyskinesiaDataChanged;
 // Function declarations
 void initializeDisplay();
 void initializeTouch();
-void checkSensorDataChanges();
 void handleTouch();
 void detectSwipe();
 void drawHomeScreen();
-void updateHomeScreenStats();
+void updateHomeScreenStats(const SensorData &data);
 void drawGraphScreen();
 void updateGraphScreen();
 
+// Pops queued UI events and redraws only what they affect
+void processUiEvents();
+
 // Helper function for P team to update sensor data
 void updateSensorData(float magnitude, bool tremorDetected, bool dyskinesiaDetected);
 
@@ -0,0 +1,54 @@
+#ifndef ZOOM_SPECTRUM_H
+#define ZOOM_SPECTRUM_H
+
+#include <Arduino.h>
+#include "Spectrum.h"
+
+// Band-limited (zoom) spectrum of the 2-8 Hz region.
+//
+// Samples are streamed in as they arrive: DC-blocked, mixed down by 5 Hz
+// so the band is centred on 0, low-pass filtered and decimated by 4 with
+// a 24-tap FIR (only every 4th output is computed), then windowed and run
+// through a 32-point complex FFT. The result covers -1.25..11.25 Hz in
+// 0.39 Hz bins, twice as fine as the 64-point full-band path, and images
+// that could fold into 2-8 Hz are at least 40 dB down. The bins are then
+// put in ascending order and go through the same feature extraction as
+// the full-band spectrum (extractSpectrumFeatures).
+//
+// The 32 complex outputs live in storage lent by the caller: the 64-float
+// full-band sample buffer, which zoom mode does not otherwise use. On the
+// 32u4 that plus 24 input floats, 12 FIR and 10 complex mixer
+// coefficients comes to 480 bytes, against 512 bytes (samples and
+// imaginary scratch) for the 64-point path.
+// A frame needs 24 + 4 * 31 = 148 samples (2.96 s).
+
+#define ZOOM_CENTER_HZ     5.0f
+#define ZOOM_DECIMATION    4
+#define ZOOM_FIR_TAPS      24       // Even, symmetric
+#define ZOOM_FFT_SIZE      32
+#define ZOOM_MIX_PERIOD    10       // FFT_SAMPLING_FREQUENCY / ZOOM_CENTER_HZ
+#define ZOOM_SAMPLE_RATE   ((float)FFT_SAMPLING_FREQUENCY / ZOOM_DECIMATION)
+#define ZOOM_BIN_HZ        (ZOOM_SAMPLE_RATE / ZOOM_FFT_SIZE)
+#define ZOOM_FIRST_BIN_HZ  (ZOOM_CENTER_HZ - ZOOM_FFT_SIZE / 2 * ZOOM_BIN_HZ)
+#define ZOOM_BAND_LOW_HZ   2.0f     // Peak search range; images are
+#define ZOOM_BAND_HIGH_HZ  8.0f     // suppressed only inside it
+#define ZOOM_FRAME_SAMPLES (ZOOM_FIR_TAPS + ZOOM_DECIMATION * (ZOOM_FFT_SIZE - 1))
+
+// Designs the filter and takes `storage` (2 * ZOOM_FFT_SIZE floats) for
+// the frame; call once before anything else
+void zoomSpectrumBegin(float storage[]);
+
+// Clears the filter and frame; call at the start of each capture
+void zoomSpectrumReset();
+
+// Feeds one sample; returns true once a full frame has been collected
+bool zoomSpectrumPush(float sample);
+
+// Transforms the collected frame and extracts the detector features
+void zoomSpectrumAnalyse(SpectrumFeatures &features);
+
+// Times a full frame (push + analyse) on a synthetic 4 Hz signal and
+// returns the average microseconds per frame
+unsigned long benchmarkZoomSpectrum(uint16_t frames);
+
+#endif
@@ -3,13 +3,14 @@
 #ifndef GRAPHING_H
 #define GRAPHING_H
 #include <Adafruit_ILI9341.h>
+#include "SensorChannel.h"
 
 extern Adafruit_ILI9341 tft;
 // extern Adafruit_TSC2007 ts;
 
-void updateGraph();
+void updateGraph(const SensorData &data);
 
-void getComment();
+void getComment(const SensorData &data);
 
 void back_to_home();
 
@@ -0,0 +1,184 @@
+#include "Acquisition.h"
+#include <Wire.h>
+#include <math.h>
+
+#define ADXL345_REG_DATAX0       0x32
+#define ADXL345_REG_FIFO_CTL     0x38
+#define ADXL345_REG_FIFO_STATUS  0x39
+
+#define ADXL345_FIFO_BYPASS      0x00
+#define ADXL345_FIFO_STREAM      0x80
+
+#define GRAVITY_OFFSET           9.802f
+
+static bool acquisitionReady = false;
+
+static int16_t history[ACQ_HISTORY_LEN];
+static uint8_t historyWrite = 0;
+static uint8_t historyCount = 0;   // Valid samples, saturates at ACQ_HISTORY_LEN
+static uint8_t unreadCount = 0;    // Samples not yet returned by acquisitionRead()
+static int16_t latest = 0;
+static uint16_t overrunCount = 0;
+
+#if ACQ_OVERSAMPLE
+// CIC state per axis. Unsigned so the integrators wrap in a defined way;
+// the combs undo the wrap as long as the output fits in 32 bits.
+static uint32_t integrator[3][ACQ_CIC_ORDER];
+static uint32_t combDelay[3][ACQ_CIC_ORDER];
+static uint8_t decimationPhase = 0;
+#else
+static unsigned long lastSampleTime = 0;
+#endif
+
+void accelWriteRegister(uint8_t reg, uint8_t value) {
+    Wire.beginTransmission(ADXL345_DEFAULT_ADDRESS);
+    Wire.write(reg);
+    Wire.write(value);
+    Wire.endTransmission();
+}
+
+uint8_t accelReadRegister(uint8_t reg) {
+    Wire.beginTransmission(ADXL345_DEFAULT_ADDRESS);
+    Wire.write(reg);
+    Wire.endTransmission();
+    Wire.requestFrom(ADXL345_DEFAULT_ADDRESS, 1);
+    return Wire.read();
+}
+
+// All six data bytes must be read in one burst for the FIFO to advance
+static void readAxes(int16_t axes[3]) {
+    Wire.beginTransmission(ADXL345_DEFAULT_ADDRESS);
+    Wire.write(ADXL345_REG_DATAX0);
+    Wire.endTransmission();
+    Wire.requestFrom(ADXL345_DEFAULT_ADDRESS, 6);
+    for (int i = 0; i < 3; i++) {
+        uint8_t lo = Wire.read();
+        uint8_t hi = Wire.read();
+        axes[i] = (int16_t)((hi << 8) | lo);
+    }
+}
+
+static float toMagnitude(int16_t value) {
+    return value * (ADXL345_MG2G_MULTIPLIER * SENSORS_GRAVITY_STANDARD / (1 << ACQ_FRAC_BITS))
+           - GRAVITY_OFFSET;
+}
+
+static void pushSample(int32_t x, int32_t y, int32_t z) {
+    float mag = sqrt((float)(x * x + y * y + z * z));
+    latest = (int16_t)(mag + 0.5f);
+    history[historyWrite] = latest;
+    historyWrite = (historyWrite + 1) % ACQ_HISTORY_LEN;
+    if (historyCount < ACQ_HISTORY_LEN) historyCount++;
+    if (unreadCount < ACQ_HISTORY_LEN) unreadCount++;  // Else the oldest is overwritten
+}
+
+#if ACQ_OVERSAMPLE
+// Runs one input sample through the integrators; every ACQ_DECIMATION
+// samples runs the combs and returns true with the decimated axes
+static bool cicPush(const int16_t axes[3], int32_t out[3]) {
+    for (int a = 0; a < 3; a++) {
+        uint32_t acc = (uint32_t)(int32_t)axes[a];
+        for (int s = 0; s < ACQ_CIC_ORDER; s++) {
+            integrator[a][s] += acc;
+            acc = integrator[a][s];
+        }
+    }
+    if (++decimationPhase < ACQ_DECIMATION) return false;
+    decimationPhase = 0;
+
+    for (int a = 0; a < 3; a++) {
+        uint32_t acc = integrator[a][ACQ_CIC_ORDER - 1];
+        for (int s = 0; s < ACQ_CIC_ORDER; s++) {
+            uint32_t prev = combDelay[a][s];
+            combDelay[a][s] = acc;
+            acc -= prev;
+        }
+        // Remove the R^N gain but keep ACQ_FRAC_BITS of the extra precision
+        out[a] = (int32_t)acc >> (ACQ_CIC_GAIN_BITS - ACQ_FRAC_BITS);
+    }
+    return true;
+}
+
+// Clearing the FIFO by toggling bypass mode also drops stale samples
+static void restartStream() {
+    accelWriteRegister(ADXL345_REG_FIFO_CTL, ADXL345_FIFO_BYPASS);
+    accelWriteRegister(ADXL345_REG_FIFO_CTL, ADXL345_FIFO_STREAM);
+    for (int a = 0; a < 3; a++) {
+        for (int s = 0; s < ACQ_CIC_ORDER; s++) {
+            integrator[a][s] = 0;
+            combDelay[a][s] = 0;
+        }
+    }
+    decimationPhase = 0;
+}
+#endif
+
+void acquisitionBegin() {
+    Wire.setClock(ACQ_I2C_CLOCK_HZ);
+#if ACQ_OVERSAMPLE
+    restartStream();
+#else
+    accelWriteRegister(ADXL345_REG_FIFO_CTL, ADXL345_FIFO_BYPASS);
+    lastSampleTime = millis();
+#endif
+    acquisitionReady = true;
+}
+
+uint8_t acquisitionPoll() {
+    if (!acquisitionReady) return 0;
+    uint8_t produced = 0;
+    int16_t axes[3];
+
+#if ACQ_OVERSAMPLE
+    // Entry count is in the low 6 bits; read at most what is there now
+    uint8_t entries = accelReadRegister(ADXL345_REG_FIFO_STATUS) & 0x3F;
+    if (entries >= ACQ_FIFO_DEPTH) {
+        // Samples were dropped at an unknown point; start over cleanly
+        overrunCount++;
+        restartStream();
+        historyCount = 0;
+        unreadCount = 0;
+        return 0;
+    }
+    int32_t decimated[3];
+    while (entries--) {
+        readAxes(axes);
+        if (cicPush(axes, decimated)) {
+            pushSample(decimated[0], decimated[1], decimated[2]);
+            produced++;
+        }
+    }
+#else
+    unsigned long now = millis();
+    if (now - lastSampleTime >= ACQ_SAMPLE_PERIOD_MS) {
+        lastSampleTime = now;
+        readAxes(axes);
+        pushSample((int32_t)axes[0] << ACQ_FRAC_BITS,
+                   (int32_t)axes[1] << ACQ_FRAC_BITS,
+                   (int32_t)axes[2] << ACQ_FRAC_BITS);
+        produced++;
+    }
+#endif
+    return produced;
+}
+
+uint8_t acquisitionRewind(uint8_t samples) {
+    unreadCount = samples < historyCount ? samples : historyCount;
+    return unreadCount;
+}
+
+bool acquisitionRead(float &sample) {
+    if (unreadCount == 0) return false;
+    uint8_t index = (historyWrite + ACQ_HISTORY_LEN - unreadCount) % ACQ_HISTORY_LEN;
+    sample = toMagnitude(history[index]);
+    unreadCount--;
+    return true;
+}
+
+uint16_t acquisitionOverruns() {
+    return overrunCount;
+}
+
+float acquisitionLatest() {
+    return toMagnitude(latest);
+}
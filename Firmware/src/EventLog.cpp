@@ -0,0 +1,213 @@
+#include "EventLog.h"
+#include <math.h>
+
+#if EVENTLOG_SLOTS % EVENTLOG_SEQ_MODULO == 0
+#error "EVENTLOG_SLOTS must not be a multiple of EVENTLOG_SEQ_MODULO"
+#endif
+
+// Index of the newest record, EVENTLOG_NO_HEAD while the log is empty
+static uint16_t headSlot = EVENTLOG_NO_HEAD;
+static uint8_t headSeq = 0;
+static unsigned long lastEventMillis = 0;
+
+#if defined(__AVR__)
+#include <EEPROM.h>
+
+static int slotAddress(uint16_t slot) {
+    return EVENTLOG_BASE + slot * EVENTLOG_RECORD_SIZE;
+}
+
+static uint8_t readRecordByte(uint16_t slot, uint8_t offset) {
+    return EEPROM.read(slotAddress(slot) + offset);
+}
+
+// Erase the sequence byte first and write it last, so a reset in the
+// middle of an append leaves an erased slot instead of a bogus record
+static void writeRecord(uint16_t slot, const uint8_t record[]) {
+    int addr = slotAddress(slot);
+    EEPROM.update(addr, EVENTLOG_SEQ_ERASED);
+    for (int i = 1; i < EVENTLOG_RECORD_SIZE; i++) {
+        EEPROM.update(addr + i, record[i]);
+    }
+    EEPROM.update(addr, record[0]);
+}
+
+static void eraseAll() {
+    for (uint16_t i = 0; i < EVENTLOG_SLOTS; i++) {
+        EEPROM.update(slotAddress(i), EVENTLOG_SEQ_ERASED);
+    }
+}
+
+#else
+// No EEPROM on the SAMD51: the ring lives in the last blocks of internal
+// flash, programmed directly through the NVM controller. Erased flash
+// reads 0xFF, which is also the erased sequence number.
+#define EVENTLOG_FLASH_BASE (FLASH_SIZE - EVENTLOG_FLASH_BLOCKS * EVENTLOG_FLASH_BLOCK_SIZE)
+
+static uint32_t slotAddress(uint16_t slot) {
+    return EVENTLOG_FLASH_BASE + (uint32_t)slot * EVENTLOG_FLASH_STRIDE;
+}
+
+static uint8_t readRecordByte(uint16_t slot, uint8_t offset) {
+    return *(volatile uint8_t *)(slotAddress(slot) + offset);
+}
+
+static void flashCommand(uint32_t address, uint32_t command) {
+    while (!NVMCTRL->STATUS.bit.READY);
+    NVMCTRL->ADDR.reg = address;
+    NVMCTRL->CTRLB.reg = NVMCTRL_CTRLB_CMDEX_KEY | command;
+    while (!NVMCTRL->STATUS.bit.READY);
+}
+
+// The CMCC caches flash reads, so drop its lines after every change
+static void invalidateFlashCache() {
+    if (CMCC->SR.bit.CSTS) {
+        CMCC->CTRL.bit.CEN = 0;
+        while (CMCC->SR.bit.CSTS);
+        CMCC->MAINT0.bit.INVALL = 1;
+        CMCC->CTRL.bit.CEN = 1;
+    }
+}
+
+static void eraseBlock(uint8_t block) {
+    flashCommand(EVENTLOG_FLASH_BASE + (uint32_t)block * EVENTLOG_FLASH_BLOCK_SIZE,
+                 NVMCTRL_CTRLB_CMD_EB);
+    invalidateFlashCache();
+}
+
+// A quad-word is programmed in one operation, so unlike the EEPROM path
+// there is no partially written record to guard against
+static void writeRecord(uint16_t slot, const uint8_t record[]) {
+    if (slot % EVENTLOG_SLOTS_PER_BLOCK == 0) {
+        eraseBlock(slot / EVENTLOG_SLOTS_PER_BLOCK);
+    }
+
+    uint32_t words[EVENTLOG_FLASH_STRIDE / 4];
+    memset(words, 0xFF, sizeof(words));
+    memcpy(words, record, EVENTLOG_RECORD_SIZE);
+
+    // Manual write mode: clear the page buffer, fill this quad-word of it
+    // through the flash address, then program just that quad-word
+    uint32_t addr = slotAddress(slot);
+    volatile uint32_t *dst = (volatile uint32_t *)addr;
+    NVMCTRL->CTRLA.bit.WMODE = NVMCTRL_CTRLA_WMODE_MAN_Val;
+    flashCommand(addr, NVMCTRL_CTRLB_CMD_PBC);
+    for (int i = 0; i < EVENTLOG_FLASH_STRIDE / 4; i++) dst[i] = words[i];
+    flashCommand(addr, NVMCTRL_CTRLB_CMD_WQW);
+    invalidateFlashCache();
+}
+
+static void eraseAll() {
+    for (uint8_t b = 0; b < EVENTLOG_FLASH_BLOCKS; b++) eraseBlock(b);
+}
+
+#endif
+
+static uint8_t readSeq(uint16_t slot) {
+    return readRecordByte(slot, 0);
+}
+
+// Scans the sequence numbers for the newest record: the one whose
+// successor is erased or does not continue the sequence
+static void findHead() {
+    headSlot = EVENTLOG_NO_HEAD;
+    for (uint16_t i = 0; i < EVENTLOG_SLOTS; i++) {
+        uint8_t seq = readSeq(i);
+        if (seq == EVENTLOG_SEQ_ERASED) continue;
+        uint8_t next = readSeq((i + 1) % EVENTLOG_SLOTS);
+        if (next != (seq + 1) % EVENTLOG_SEQ_MODULO) {
+            headSlot = i;
+            headSeq = seq;
+            return;
+        }
+    }
+}
+
+
+// 16 steps per octave, so 255 covers amplitudes up to ~2^16
+uint8_t eventLogEncodeAmplitude(float amplitude) {
+    if (amplitude <= 0.0f) return 0;
+    float code = 16.0f * log(1.0f + amplitude) / log(2.0f);
+    if (code > 255.0f) return 255;
+    return (uint8_t)(code + 0.5f);
+}
+
+uint8_t eventLogEncodeFrequency(float peakHz) {
+    if (peakHz <= 0.0f) return EVENTLOG_FREQ_NONE;
+    float code = peakHz / EVENTLOG_FREQ_STEP_HZ + 0.5f;
+    if (code < 1.0f) return 1;
+    if (code > EVENTLOG_FREQ_MAX) return EVENTLOG_FREQ_MAX;
+    return (uint8_t)code;
+}
+
+static void appendRecord(EventType type, uint8_t peakCode, uint8_t amplitudeCode) {
+    unsigned long now = millis();
+    unsigned long seconds = (now - lastEventMillis) / 1000;
+    if (seconds > 0xFFFF) seconds = 0xFFFF;
+    // Carry the sub-second remainder so deltas don't drift
+    lastEventMillis = now - (now - lastEventMillis) % 1000;
+
+    uint16_t slot = 0;
+    uint8_t seq = 0;
+    if (headSlot != EVENTLOG_NO_HEAD) {
+        slot = (headSlot + 1) % EVENTLOG_SLOTS;
+        seq = (headSeq + 1) % EVENTLOG_SEQ_MODULO;
+    }
+
+    uint8_t record[EVENTLOG_RECORD_SIZE] = {
+        seq,
+        (uint8_t)(((uint8_t)type << 6) | (peakCode & 0x3F)),
+        amplitudeCode,
+        (uint8_t)(seconds & 0xFF),
+        (uint8_t)((seconds >> 8) & 0xFF)
+    };
+    writeRecord(slot, record);
+
+    headSlot = slot;
+    headSeq = seq;
+}
+
+void eventLogBegin() {
+    findHead();
+    lastEventMillis = millis();
+    appendRecord(EVENT_BOOT, 0, EVENTLOG_DUMP_VERSION);
+}
+
+void eventLogAppend(EventType type, uint8_t peakCode, float peakAmplitude) {
+    appendRecord(type, peakCode, eventLogEncodeAmplitude(peakAmplitude));
+}
+
+// Frame: "ELOG", version, record size, slots (u16), head (u16),
+// raw ring bytes, then a 16-bit sum of the raw bytes. All little endian.
+void eventLogDump(Stream &out) {
+    uint8_t header[10] = {
+        'E', 'L', 'O', 'G',
+        EVENTLOG_DUMP_VERSION, EVENTLOG_RECORD_SIZE,
+        EVENTLOG_SLOTS & 0xFF, EVENTLOG_SLOTS >> 8,
+        (uint8_t)(headSlot & 0xFF), (uint8_t)(headSlot >> 8)
+    };
+    out.write(header, sizeof(header));
+
+    // Stream in small chunks so the USB serial buffer is filled in bulk
+    uint8_t chunk[32];
+    uint16_t checksum = 0;
+    uint8_t n = 0;
+    for (uint16_t slot = 0; slot < EVENTLOG_SLOTS; slot++) {
+        for (uint8_t j = 0; j < EVENTLOG_RECORD_SIZE; j++) {
+            chunk[n] = readRecordByte(slot, j);
+            checksum += chunk[n];
+            if (++n == sizeof(chunk)) {
+                out.write(chunk, n);
+                n = 0;
+            }
+        }
+    }
+    if (n) out.write(chunk, n);
+    out.write(checksum & 0xFF);
+    out.write(checksum >> 8);
+}
+
+void eventLogErase() {
+    eraseAll();
+    headSlot = EVENTLOG_NO_HEAD;
+}
@@ -0,0 +1,70 @@
+#include "SensorChannel.h"
+
+// Keeps the compiler from moving snapshot accesses across the
+// sequence/index updates; both targets are single core
+#define COMPILER_BARRIER() asm volatile("" ::: "memory")
+
+// Interrupt masking that restores the previous state, so posting from
+// inside an ISR does not re-enable interrupts early
+#if defined(__AVR__)
+#define QUEUE_LOCK()   uint8_t savedState = SREG; cli()
+#define QUEUE_UNLOCK() SREG = savedState
+#else
+#define QUEUE_LOCK()   uint32_t savedState = __get_PRIMASK(); __disable_irq()
+#define QUEUE_UNLOCK() __set_PRIMASK(savedState)
+#endif
+
+static SensorData snapshots[2] = {{0.0, false, false, 0}, {0.0, false, false, 0}};
+static volatile uint8_t publishedIndex = 0;
+static volatile uint8_t publishSeq = 0;
+
+void publishSensorData(const SensorData &data) {
+    uint8_t spare = publishedIndex ^ 1;
+    snapshots[spare] = data;
+    COMPILER_BARRIER();
+    publishedIndex = spare;
+    publishSeq++;
+}
+
+// A retry is only needed if the writer published twice during the copy
+// and so reused the side being read
+void readSensorSnapshot(SensorData &out) {
+    uint8_t seq;
+    do {
+        seq = publishSeq;
+        COMPILER_BARRIER();
+        out = snapshots[publishedIndex];
+        COMPILER_BARRIER();
+    } while (seq != publishSeq);
+}
+
+static UiEvent events[UI_EVENT_QUEUE_LEN];
+static volatile uint8_t eventHead = 0;   // Next slot to pop
+static volatile uint8_t eventTail = 0;   // Next slot to fill
+
+bool postUiEvent(uint8_t type, int16_t a, int16_t b) {
+    // Producers may run in interrupts, so claim the slot atomically
+    QUEUE_LOCK();
+    uint8_t tail = eventTail;
+    if ((uint8_t)(tail - eventHead) >= UI_EVENT_QUEUE_LEN) {
+        QUEUE_UNLOCK();
+        return false;
+    }
+    UiEvent &slot = events[tail & (UI_EVENT_QUEUE_LEN - 1)];
+    slot.type = type;
+    slot.a = a;
+    slot.b = b;
+    eventTail = tail + 1;
+    QUEUE_UNLOCK();
+    return true;
+}
+
+// Single consumer: the UI loop
+bool popUiEvent(UiEvent &event) {
+    uint8_t head = eventHead;
+    if (head == eventTail) return false;
+    event = events[head & (UI_EVENT_QUEUE_LEN - 1)];
+    COMPILER_BARRIER();
+    eventHead = head + 1;
+    return true;
+}
@@ -0,0 +1,99 @@
+#include "SequentialDetector.h"
+#include "Spectrum.h"
+#include <math.h>
+
+#define POWER_SMOOTHING 16       // Power average time constant in samples
+
+struct Biquad {
+    float b0, b2, a1, a2;        // Band-pass: b1 is always 0
+    float z1, z2;
+};
+
+static Biquad bands[2];
+static float evidence[2];
+static float power = 0.0f;
+static DcBlocker dcBlocker;
+static uint8_t samplesSeen = 0;
+static uint8_t scoreFrom = SEQ_WARMUP_SAMPLES;
+static uint8_t powerCount = 0;
+static bool coefficientsReady = false;
+
+// RBJ cookbook band-pass with 0 dB peak gain
+static void designBandPass(Biquad &f, float centerHz, float q) {
+    float w0 = 2.0f * M_PI * centerHz / SEQ_SAMPLE_RATE_HZ;
+    float alpha = sin(w0) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+    f.b0 = alpha / a0;
+    f.b2 = -alpha / a0;
+    f.a1 = -2.0f * cos(w0) / a0;
+    f.a2 = (1.0f - alpha) / a0;
+}
+
+// Transposed direct form II
+static float runBiquad(Biquad &f, float x) {
+    float y = f.b0 * x + f.z1;
+    f.z1 = -f.a1 * y + f.z2;
+    f.z2 = f.b2 * x - f.a2 * y;
+    return y;
+}
+
+void sequentialDetectorReset(uint8_t primingSamples) {
+    if (!coefficientsReady) {
+        designBandPass(bands[0], SEQ_TREMOR_CENTER_HZ, SEQ_TREMOR_Q);
+        designBandPass(bands[1], SEQ_DYSK_CENTER_HZ, SEQ_DYSK_Q);
+        coefficientsReady = true;
+    }
+    for (int i = 0; i < 2; i++) {
+        bands[i].z1 = 0.0f;
+        bands[i].z2 = 0.0f;
+        evidence[i] = 0.0f;
+    }
+    power = 0.0f;
+    dcBlockerReset(dcBlocker);
+    samplesSeen = 0;
+    powerCount = 0;
+    scoreFrom = primingSamples > SEQ_WARMUP_SAMPLES ? primingSamples : SEQ_WARMUP_SAMPLES;
+}
+
+SequentialDecision sequentialDetectorUpdate(float sample) {
+    float dcOutput = dcBlockerStep(dcBlocker, sample);
+    // Running mean until POWER_SMOOTHING samples are in, so the estimate
+    // starts at the signal's power instead of ramping up from 0
+    if (powerCount < POWER_SMOOTHING) powerCount++;
+    power += (dcOutput * dcOutput - power) / powerCount;
+
+    float bandOut[2];
+    for (int i = 0; i < 2; i++) {
+        bandOut[i] = runBiquad(bands[i], dcOutput);
+    }
+
+    // Pre-trigger history only primes the filters. The power average
+    // restarts at the trigger: a quiet history would otherwise hold it
+    // under SEQ_QUIET_POWER and count the onset as evidence of stillness.
+    if (samplesSeen < scoreFrom) {
+        samplesSeen++;
+        if (samplesSeen == scoreFrom && scoreFrom > SEQ_WARMUP_SAMPLES) powerCount = 0;
+        return SEQ_UNDECIDED;
+    }
+
+    // Gaussian variance test: band output ~ N(0, ratio * power) under each
+    // hypothesis, so the per-sample log-likelihood ratio is
+    // 0.5 ln(r0/r1) + y^2 / (2 P) * (1/r0 - 1/r1)
+    static const float bias = 0.5f * log(SEQ_RATIO_H0 / SEQ_RATIO_H1);
+    static const float gain = 0.5f * (1.0f / SEQ_RATIO_H0 - 1.0f / SEQ_RATIO_H1);
+    for (int i = 0; i < 2; i++) {
+        float step;
+        if (power < SEQ_QUIET_POWER) {
+            step = SEQ_QUIET_EVIDENCE;
+        } else {
+            step = SEQ_EVIDENCE_SCALE * (bias + gain * bandOut[i] * bandOut[i] / power);
+        }
+        // Clamping keeps old evidence from delaying a change of state
+        evidence[i] = constrain(evidence[i] + step, SEQ_THRESHOLD_LOWER, SEQ_THRESHOLD_UPPER);
+    }
+
+    if (evidence[0] >= SEQ_THRESHOLD_UPPER && evidence[0] >= evidence[1]) return SEQ_TREMOR;
+    if (evidence[1] >= SEQ_THRESHOLD_UPPER) return SEQ_DYSKINESIA;
+    if (evidence[0] <= SEQ_THRESHOLD_LOWER && evidence[1] <= SEQ_THRESHOLD_LOWER) return SEQ_CLEAR;
+    return SEQ_UNDECIDED;
+}
@@ -0,0 +1,155 @@
+#include "Spectrum.h"
+#include <math.h>
+
+#if SPECTRUM_USE_CMSIS
+#include <arm_math.h>
+
+static arm_rfft_fast_instance_f32 rfft;
+static float rfftWindow[FFT_SIZE];
+static float rfftOut[FFT_SIZE];
+static bool rfftReady = false;
+
+static void initRfft() {
+    arm_rfft_fast_init_f32(&rfft, FFT_SIZE);
+    for (int i = 0; i < FFT_SIZE; i++) {
+        rfftWindow[i] = hammingWindow(i, FFT_SIZE);
+    }
+    rfftReady = true;
+}
+
+void computeMagnitudeSpectrum(float samples[]) {
+    if (!rfftReady) initRfft();
+    arm_mult_f32(samples, rfftWindow, samples, FFT_SIZE);
+    arm_rfft_fast_f32(&rfft, samples, rfftOut, 0);
+
+    // Packed output: [0] is DC and [1] is Nyquist, both purely real
+    float nyquist = fabs(rfftOut[1]);
+    rfftOut[1] = 0.0f;
+    arm_cmplx_mag_f32(rfftOut, samples, FFT_SIZE / 2);
+    samples[FFT_SIZE / 2] = nyquist;
+    for (int i = 1; i < FFT_SIZE / 2; i++) {
+        samples[FFT_SIZE - i] = samples[i];
+    }
+}
+
+#else
+#include <ArduinoFFT.h>
+
+static float imagScratch[FFT_SIZE];
+
+void computeMagnitudeSpectrum(float samples[]) {
+    for (int i = 0; i < FFT_SIZE; i++) imagScratch[i] = 0.0f;
+    ArduinoFFT<float> fft(samples, imagScratch, FFT_SIZE, FFT_SAMPLING_FREQUENCY);
+    fft.windowing(FFT_WIN_TYP_HAMMING, FFT_FORWARD);
+    fft.compute(FFT_FORWARD);
+    fft.complexToMagnitude();
+}
+
+#endif
+
+float hammingWindow(int i, int n) {
+    return 0.54f - 0.46f * cos(2.0f * PI * i / (n - 1));
+}
+
+void dcBlockerReset(DcBlocker &filter) {
+    filter.prevInput = 0.0f;
+    filter.output = 0.0f;
+    filter.primed = false;
+}
+
+float dcBlockerStep(DcBlocker &filter, float sample) {
+    if (!filter.primed) {
+        filter.prevInput = sample;
+        filter.primed = true;
+    }
+    filter.output = DC_BLOCK_POLE * (filter.output + sample - filter.prevInput);
+    filter.prevInput = sample;
+    return filter.output;
+}
+
+// Fractional bin offset (-0.5..0.5) of the true peak from its neighbours.
+// Fits a parabola to the log magnitudes (exact for a Gaussian-shaped
+// window peak); falls back to linear magnitudes when a neighbour is 0.
+float interpolatePeakOffset(float left, float center, float right) {
+    if (left > 0.0f && right > 0.0f) {
+        left = log(left);
+        center = log(center);
+        right = log(right);
+    }
+    float denom = left - 2.0f * center + right;
+    if (denom == 0.0f) return 0.0f;
+    float offset = 0.5f * (left - right) / denom;
+    if (offset > 0.5f) offset = 0.5f;
+    if (offset < -0.5f) offset = -0.5f;
+    return offset;
+}
+
+int spectrumFloor(const float mag[], int count) {
+    int mean = 0;
+    for (int i = 0; i < count; i++) {
+        mean += mag[i];
+    }
+    mean /= count;
+    return 3 * mean / 4;
+}
+
+static float peakScore(float magnitude, float freq, int floor) {
+    float score = magnitude - floor;
+    if (freq < LOW_BIN_MAX_HZ) score += LOW_BIN_BIAS;
+    if (3.0f < freq && freq < 5.0f) score *= 1.15f;
+    if (5.0f < freq && freq < 7.0f) score *= 0.95f;
+    return score;
+}
+
+void extractSpectrumFeatures(const float mag[], int bins, float firstHz, float binHz,
+                             float searchLowHz, float searchHighHz, int floor,
+                             SpectrumFeatures &features) {
+    float total = 0.0f;
+    float tremorEnergy = 0.0f;
+    float dyskinesiaEnergy = 0.0f;
+    float maxScore = 0.0f;
+    int peak = -1;
+    for (int k = 0; k < bins; k++) {
+        float freq = firstHz + k * binHz;
+        if (freq >= BAND_TOTAL_MIN_HZ) {
+            float energy = mag[k] * mag[k];
+            total += energy;
+            if (freq >= 3.0f && freq < 5.0f) tremorEnergy += energy;
+            if (freq >= 5.0f && freq < 7.0f) dyskinesiaEnergy += energy;
+        }
+        if (freq >= searchLowHz && freq < searchHighHz) {
+            float score = peakScore(mag[k], freq, floor);
+            if (score > maxScore) {
+                maxScore = score;
+                peak = k;
+            }
+        }
+    }
+    features.tremorRatio = total > 0.0f ? tremorEnergy / total : 0.0f;
+    features.dyskinesiaRatio = total > 0.0f ? dyskinesiaEnergy / total : 0.0f;
+
+    features.peakFreq = 0.0f;
+    features.peakAmp = 0.0f;
+    if (peak < 0) return;
+    features.peakFreq = firstHz + peak * binHz;
+    features.peakAmp = mag[peak];
+    // The weights step at 3, 5 and 7 Hz, so interpolating on weighted
+    // values would pull peaks across those edges. Skip DC as a neighbour.
+    if (peak > 0 && peak < bins - 1 && firstHz + (peak - 1) * binHz > 0.0f) {
+        float offset = interpolatePeakOffset(mag[peak - 1], mag[peak], mag[peak + 1]);
+        features.peakFreq += offset * binHz;
+    }
+}
+
+unsigned long benchmarkSpectrum(float scratch[], uint16_t frames) {
+    unsigned long total = 0;
+    for (uint16_t f = 0; f < frames; f++) {
+        for (int i = 0; i < FFT_SIZE; i++) {
+            scratch[i] = sin(2.0f * PI * 4.0f * i / FFT_SAMPLING_FREQUENCY);
+        }
+        unsigned long start = micros();
+        computeMagnitudeSpectrum(scratch);
+        total += micros() - start;
+    }
+    return frames ? total / frames : 0;
+}
@@ -3,15 +3,29 @@
 #include <SPI.h>
 #include <Wire.h>
 #include <Arduino.h>
+#if defined(__SAMD51__)
+#if !defined(USE_SPI_DMA)
+#error "Build the Feather M4 with -DUSE_SPI_DMA (see platformio.ini)"
+#endif
+#include <Adafruit_ZeroDMA.h>
+#endif
 
 // Static variables for tracking last displayed values
 static float lastTremorIntensityDisplayed = -1.0;
+static int16_t lastPeakTenthsHz = UI_PEAK_NONE;  // Redrawn with the home screen
 
 void initializeDisplay() {
+#if defined(__SAMD51__)
+    // With USE_SPI_DMA, Adafruit_SPITFT sends fills and pixel blocks
+    // through Zero DMA instead of byte by byte. Calls still wait for the
+    // transfer to finish, so run the bus at the ILI9341's write limit
+    tft.begin(TFT_SPI_FREQ_SAMD51);
+#else
     // Initialize SPI bus (required for ILI9341)
     SPI.begin();
     SPI.setClockDivider(SPI_CLOCK_DIV2);
     tft.begin();
+#endif
     tft.setRotation(3);
     tft.fillScreen(BLACK);
 }
@@ -33,15 +47,15 @@ void drawHomeScreen() {
     tft.print("Graph");
 }
 
-void updateHomeScreenStats() {
+void updateHomeScreenStats(const SensorData &data) {
     // Only update the main status area (100, 80)
     tft.fillRect(50, 80, 250, 100, BLACK); // Clear status area
 
     tft.setTextSize(4);
-    if (sensorData.tremorDetected || sensorData.dyskinesiaDetected) {
+    if (data.tremorDetected || data.dyskinesiaDetected) {
         tft.setTextColor(RED);
         tft.setCursor(50, 100);
-        if (sensorData.tremorDetected) {
+        if (data.tremorDetected) {
             tft.print("Tremors!");
         } else {
             tft.print("Dyskinesia!");
@@ -51,10 +65,19 @@ void updateHomeScreenStats() {
         tft.setCursor(100, 100);
         tft.print("OK");
     }
+}
 
-    // Reset flags after update
-    tremorDataChanged = false;
-    dyskinesiaDataChanged = false;
+// Peak frequency of the last analysed capture, below the status;
+// blank when the last capture ended without a spectrum
+static void updateHomeScreenPeak(int16_t tenthsHz) {
+    tft.fillRect(10, 182, 180, 16, BLACK);
+    if (tenthsHz == UI_PEAK_NONE) return;
+    tft.setTextSize(2);
+    tft.setTextColor(LIGHTGRAY);
+    tft.setCursor(10, 182);
+    tft.print(F("Peak:"));
+    tft.print(tenthsHz / 10.0f, 1);
+    tft.print(F("Hz"));
 }
 
 void drawGraphScreen() {
@@ -78,8 +101,6 @@ void drawGraphScreen() {
 }
 
 void updateGraphScreen() {
-    extern void updateGraph();
-    extern void getComment();
     extern void startGraph();
     
     if (!graphScreenDrawn) {
@@ -90,27 +111,43 @@ void updateGraphScreen() {
         return;  // Don't update graph on first draw, wait for next call
     }
     
-    updateGraph();
-    getComment();
+    // One snapshot per redraw so graph, comment and label agree
+    SensorData data;
+    readSensorSnapshot(data);
+    updateGraph(data);
+    getComment(data);
     
     // Update magnitude display (positioned to not overlap with Home button)
-    if (abs(sensorData.magnitude - lastTremorIntensityDisplayed) > 1.0) {
+    if (abs(data.magnitude - lastTremorIntensityDisplayed) > 1.0) {
         tft.fillRect(150, 210, 80, 20, BLACK); // Clear mag area (above Home button)
         tft.setTextSize(2);
         tft.setTextColor(BLUE);
         tft.setCursor(150, 210);
         tft.print("M:");
-        tft.print((int)sensorData.magnitude);
-        lastTremorIntensityDisplayed = sensorData.magnitude;
+        tft.print((int)data.magnitude);
+        lastTremorIntensityDisplayed = data.magnitude;
     }
 }
 
-// Helper function for P team to update sensor data
+// Helper function for P team to update sensor data.
+// Publishes a snapshot and posts events for whatever changed.
 void updateSensorData(float magnitude, bool tremorDetected, bool dyskinesiaDetected) {
-    sensorData.magnitude = magnitude;
-    sensorData.tremorDetected = tremorDetected;
-    sensorData.dyskinesiaDetected = dyskinesiaDetected;
-    sensorData.timestamp = millis();
+    static bool publishedTremor = false;
+    static bool publishedDyskinesia = false;
+    static unsigned long lastSampleEvent = 0;
+
+    SensorData data = {magnitude, tremorDetected, dyskinesiaDetected, millis()};
+    publishSensorData(data);
+
+    if (tremorDetected != publishedTremor || dyskinesiaDetected != publishedDyskinesia) {
+        publishedTremor = tremorDetected;
+        publishedDyskinesia = dyskinesiaDetected;
+        postUiEvent(UI_EVENT_STATE_CHANGED);
+    }
+    if (data.timestamp - lastSampleEvent >= GRAPH_SAMPLE_PERIOD_MS) {
+        lastSampleEvent = data.timestamp;
+        postUiEvent(UI_EVENT_NEW_SAMPLE);
+    }
 }
 
 // --- Touch/Navigation Logic (tap-only, no swipe) ---
@@ -121,31 +158,64 @@ void initializeTouch() {
     touchscreenAvailable = ts.begin();
 }
 
-void checkSensorDataChanges() {
-    // Simplified logic: set flags immediately if state changes
-    static bool lastTremorState = false;
-    static bool lastDyskState = false;
-
-    bool prevTremor = lastTremorState;
-    bool prevDysk = lastDyskState;
+static void showHomeScreen(const SensorData &data) {
+    currentScreen = SCREEN_HOME;
+    graphScreenDrawn = false;
+    drawHomeScreen();
+    updateHomeScreenStats(data);
+    updateHomeScreenPeak(lastPeakTenthsHz);
+}
 
-    if (sensorData.tremorDetected != lastTremorState) {
-        if (sensorData.tremorDetected) tremorDataChanged = true;
-        lastTremorState = sensorData.tremorDetected;
-    }
-    if (sensorData.dyskinesiaDetected != lastDyskState) {
-        if (sensorData.dyskinesiaDetected) dyskinesiaDataChanged = true;
-        lastDyskState = sensorData.dyskinesiaDetected;
-    }
+static void handleStateChanged() {
+    SensorData data;
+    readSensorSnapshot(data);
 
     // If we are on the graph screen and a warning just appeared,
     // automatically return to the home screen to show the warning clearly.
-    // bool prevWarning = prevTremor || prevDysk;
-    bool currWarning = sensorData.tremorDetected || sensorData.dyskinesiaDetected;
+    bool currWarning = data.tremorDetected || data.dyskinesiaDetected;
     if (currentScreen == SCREEN_GRAPH && currWarning) {
-        currentScreen = SCREEN_HOME;
-        graphScreenDrawn = false;  // Force home redraw next frame
-        drawHomeScreen();          // Immediate visual feedback
+        showHomeScreen(data);
+    } else if (currentScreen == SCREEN_HOME) {
+        updateHomeScreenStats(data);
+    }
+}
+
+static void handleTouchAt(int x, int y) {
+    if (currentScreen == SCREEN_HOME) {
+        // Graph button rectangle: x 200-300, y 200-230
+        if (x >= 200 && x <= 300 && y >= 200 && y <= 230) {
+            currentScreen = SCREEN_GRAPH;
+            graphScreenDrawn = false;  // Force graph screen to initialize
+            updateGraphScreen();
+        }
+    } else if (currentScreen == SCREEN_GRAPH) {
+        // Home button rectangle: x 20-120, y 210-239
+        if (x >= 20 && x <= 120 && y >= 210 && y <= 239) {
+            SensorData data;
+            readSensorSnapshot(data);
+            showHomeScreen(data);
+        }
+    }
+}
+
+void processUiEvents() {
+    UiEvent event;
+    while (popUiEvent(event)) {
+        switch (event.type) {
+            case UI_EVENT_STATE_CHANGED:
+                handleStateChanged();
+                break;
+            case UI_EVENT_NEW_SAMPLE:
+                if (currentScreen == SCREEN_GRAPH) updateGraphScreen();
+                break;
+            case UI_EVENT_NEW_SPECTRUM:
+                lastPeakTenthsHz = event.a;
+                if (currentScreen == SCREEN_HOME) updateHomeScreenPeak(event.a);
+                break;
+            case UI_EVENT_TOUCH:
+                handleTouchAt(event.a, event.b);
+                break;
+        }
     }
 }
 
@@ -172,21 +242,7 @@ void handleTouch() {
     // Map raw touch to screen coordinates for rotation=3 (landscape)
     int x = map(p.y, 0, 4095, tft.width(), 0);
     int y = map(p.x, 0, 4095, 0, tft.height());
-
-    if (currentScreen == SCREEN_HOME) {
-        // Graph button rectangle: x 200-300, y 200-230
-        if (x >= 200 && x <= 300 && y >= 200 && y <= 230) {
-            currentScreen = SCREEN_GRAPH;
-            graphScreenDrawn = false;  // Force graph screen to initialize on next update
-        }
-    } else if (currentScreen == SCREEN_GRAPH) {
-        // Home button rectangle: x 20-120, y 210-239
-        if (x >= 20 && x <= 120 && y >= 210 && y <= 239) {
-            currentScreen = SCREEN_HOME;
-            graphScreenDrawn = false;
-            drawHomeScreen();
-        }
-    }
+    postUiEvent(UI_EVENT_TOUCH, x, y);
 }
 
 void detectSwipe() {
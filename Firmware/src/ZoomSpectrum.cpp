@@ -0,0 +1,159 @@
+#include "ZoomSpectrum.h"
+#include <math.h>
+
+#define FIR_CUTOFF_HZ (ZOOM_SAMPLE_RATE / 2.0f)
+
+static float firHalf[ZOOM_FIR_TAPS / 2];   // Symmetric, so half is enough
+static float mixCos[ZOOM_MIX_PERIOD];
+static float mixSin[ZOOM_MIX_PERIOD];
+
+static float history[ZOOM_FIR_TAPS];       // DC-blocked input, not yet mixed
+static uint8_t historyPos = 0;
+static uint8_t inputsSeen = 0;             // Saturates at ZOOM_FIR_TAPS
+static uint8_t mixPhase = 0;
+static uint8_t decimationPhase = 0;
+static DcBlocker dcBlocker;
+
+static float *frame = 0;                   // 2 * ZOOM_FFT_SIZE, lent by the caller
+static uint8_t outputCount = 0;
+
+// Both backends leave the magnitudes in frame[0..ZOOM_FFT_SIZE)
+#if SPECTRUM_USE_CMSIS
+#include <arm_math.h>
+#include <arm_const_structs.h>
+#define CFFT_INSTANCE_(n) arm_cfft_sR_f32_len##n
+#define CFFT_INSTANCE(n) CFFT_INSTANCE_(n)
+
+// Interleaved, as arm_cfft_f32 takes it, so the transform runs in place
+#define ZOOM_RE(i) frame[2 * (i)]
+#define ZOOM_IM(i) frame[2 * (i) + 1]
+
+static void computeZoomMagnitudes() {
+    arm_cfft_f32(&CFFT_INSTANCE(ZOOM_FFT_SIZE), frame, 0, 1);
+    // Reads two floats before writing one, so in place is safe
+    arm_cmplx_mag_f32(frame, frame, ZOOM_FFT_SIZE);
+}
+
+#else
+#include <ArduinoFFT.h>
+
+#define ZOOM_RE(i) frame[i]
+#define ZOOM_IM(i) frame[ZOOM_FFT_SIZE + (i)]
+
+static void computeZoomMagnitudes() {
+    ArduinoFFT<float> fft(frame, frame + ZOOM_FFT_SIZE, ZOOM_FFT_SIZE, ZOOM_SAMPLE_RATE);
+    fft.compute(FFT_FORWARD);
+    fft.complexToMagnitude();
+}
+
+#endif
+
+static float firTap(uint8_t k) {
+    return firHalf[k < ZOOM_FIR_TAPS / 2 ? k : ZOOM_FIR_TAPS - 1 - k];
+}
+
+// Hamming-windowed sinc low-pass at the decimated Nyquist, unity DC gain
+static void designCoefficients() {
+    float sum = 0.0f;
+    for (int k = 0; k < ZOOM_FIR_TAPS / 2; k++) {
+        float t = k - (ZOOM_FIR_TAPS - 1) / 2.0f;
+        float x = 2.0f * FIR_CUTOFF_HZ / FFT_SAMPLING_FREQUENCY * t;
+        firHalf[k] = sin(PI * x) / (PI * x) * hammingWindow(k, ZOOM_FIR_TAPS);
+        sum += 2.0f * firHalf[k];
+    }
+    for (int k = 0; k < ZOOM_FIR_TAPS / 2; k++) firHalf[k] /= sum;
+
+    for (int p = 0; p < ZOOM_MIX_PERIOD; p++) {
+        mixCos[p] = cos(2.0f * PI * p / ZOOM_MIX_PERIOD);
+        mixSin[p] = sin(2.0f * PI * p / ZOOM_MIX_PERIOD);
+    }
+}
+
+void zoomSpectrumBegin(float storage[]) {
+    frame = storage;
+    designCoefficients();
+    zoomSpectrumReset();
+}
+
+void zoomSpectrumReset() {
+    historyPos = 0;
+    inputsSeen = 0;
+    mixPhase = 0;
+    decimationPhase = 0;
+    dcBlockerReset(dcBlocker);
+    outputCount = 0;
+}
+
+bool zoomSpectrumPush(float sample) {
+    if (outputCount >= ZOOM_FFT_SIZE) return true;
+
+    uint8_t newest = historyPos;
+    uint8_t phase = mixPhase;
+    history[newest] = dcBlockerStep(dcBlocker, sample);
+    historyPos = (historyPos + 1) % ZOOM_FIR_TAPS;
+    mixPhase = (mixPhase + 1) % ZOOM_MIX_PERIOD;
+
+    // First output once the FIR is full, then one every ZOOM_DECIMATION
+    if (inputsSeen < ZOOM_FIR_TAPS) {
+        if (++inputsSeen < ZOOM_FIR_TAPS) return false;
+    } else if (++decimationPhase < ZOOM_DECIMATION) {
+        return false;
+    }
+    decimationPhase = 0;
+
+    // Mix each tap by e^(-j w n) as it is used, so only real samples
+    // need to be stored
+    float re = 0.0f;
+    float im = 0.0f;
+    for (uint8_t k = 0; k < ZOOM_FIR_TAPS; k++) {
+        float v = firTap(k) * history[(newest + ZOOM_FIR_TAPS - k) % ZOOM_FIR_TAPS];
+        uint8_t p = (phase + ZOOM_MIX_PERIOD * 3 - k) % ZOOM_MIX_PERIOD;
+        re += v * mixCos[p];
+        im -= v * mixSin[p];
+    }
+    ZOOM_RE(outputCount) = re;
+    ZOOM_IM(outputCount) = im;
+    outputCount++;
+    return outputCount >= ZOOM_FFT_SIZE;
+}
+
+void zoomSpectrumAnalyse(SpectrumFeatures &features) {
+    // Same Hamming window as the full-band path, on both components
+    for (int i = 0; i < ZOOM_FFT_SIZE; i++) {
+        float window = hammingWindow(i, ZOOM_FFT_SIZE);
+        ZOOM_RE(i) *= window;
+        ZOOM_IM(i) *= window;
+    }
+    computeZoomMagnitudes();
+
+    // Negative offsets come out in the upper half; swap the halves so bin
+    // k sits at ZOOM_FIRST_BIN_HZ + k * ZOOM_BIN_HZ
+    for (int i = 0; i < ZOOM_FFT_SIZE / 2; i++) {
+        float t = frame[i];
+        frame[i] = frame[i + ZOOM_FFT_SIZE / 2];
+        frame[i + ZOOM_FFT_SIZE / 2] = t;
+    }
+    extractSpectrumFeatures(frame, ZOOM_FFT_SIZE, ZOOM_FIRST_BIN_HZ, ZOOM_BIN_HZ,
+                            ZOOM_BAND_LOW_HZ, ZOOM_BAND_HIGH_HZ,
+                            spectrumFloor(frame, ZOOM_FFT_SIZE), features);
+}
+
+unsigned long benchmarkZoomSpectrum(uint16_t frames) {
+    // 4 Hz at 50 Hz repeats every 25 samples; keep sin() out of the timing
+    float signal[25];
+    for (int i = 0; i < 25; i++) {
+        signal[i] = sin(2.0f * PI * 4.0f * i / FFT_SAMPLING_FREQUENCY);
+    }
+
+    SpectrumFeatures features;
+    unsigned long total = 0;
+    for (uint16_t f = 0; f < frames; f++) {
+        zoomSpectrumReset();
+        unsigned long start = micros();
+        for (int i = 0; !zoomSpectrumPush(signal[i % 25]); i++) {
+        }
+        zoomSpectrumAnalyse(features);
+        total += micros() - start;
+    }
+    return frames ? total / frames : 0;
+}
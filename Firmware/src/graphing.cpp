@@ -24,9 +24,8 @@ bool lastCommentInitialized = false;
 bool graphActive = true;
 
 // Simplified autoscaling - removed complex float math to save flash
-void autoscale_upd(){
-    extern SensorData sensorData;
-    float mag = sensorData.magnitude;
+void autoscale_upd(const SensorData &data){
+    float mag = data.magnitude;
     if(mag > max_mag_val){
         max_scale_detect = mag + 10;  // Simple margin
     }
@@ -68,16 +67,15 @@ void startGraph() {
     draw_graph_axis();  // Draw axes after clearing
 }
 
-void updateGraph(){
+void updateGraph(const SensorData &data){
     if (!graphActive) return;
-    extern SensorData sensorData;
     
-    autoscale_upd();
+    autoscale_upd(data);
     autoscale();
     
-    // Use sensorData.magnitude for actual data
+    // Use data.magnitude for actual data
     // For testing: if magnitude is 0, use random value
-    float mag = sensorData.magnitude;
+    float mag = data.magnitude;
     if (mag == 0.0) {
         mag = random(10, 50);  // Random test value between 10-50
     }
@@ -107,10 +105,9 @@ void updateGraph(){
 }
 
 // Simplified comment function - removed redundant checks
-void getComment(){
+void getComment(const SensorData &data){
     if (!graphActive) return;
-    extern SensorData sensorData;
-    bool currentHigh = sensorData.dyskinesiaDetected || sensorData.tremorDetected;
+    bool currentHigh = data.dyskinesiaDetected || data.tremorDetected;
     if (lastCommentInitialized && currentHigh == lastCommentHigh) return;
     
     //tft.fillRect(50, 200, 270, 40, BLACK);
@@ -2,9 +2,13 @@
 #include <Wire.h>
 #include <Adafruit_Sensor.h>
 #include <Adafruit_ADXL345_U.h>
-#include <ArduinoFFT.h>
 #include <math.h>
 #include "TFT_UI_Helper.h"
+#include "EventLog.h"
+#include "Acquisition.h"
+#include "SequentialDetector.h"
+#include "Spectrum.h"
+#include "ZoomSpectrum.h"
 
 /* ================= ADXL345 registers ================= */
 #define ADXL345_REG_THRESH_ACT   0x24
@@ -14,34 +18,60 @@
 #define ADXL345_REG_INT_SOURCE   0x30
 
 /* ================= Sampling config ================= */
-#define SAMPLE_PERIOD_MS  20
+// Sample timing and anti-alias decimation live in Acquisition.h
 // Use same number of samples as FFT size to avoid buffer overflows
 #define SAMPLE_COUNT      FFT_SIZE
+// Samples from before the motion trigger that seed each capture window,
+// at most ACQ_HISTORY_LEN. Half a window keeps the onset while still
+// centring the capture on the movement that fired the interrupt.
+#define PRETRIGGER_SAMPLES (SAMPLE_COUNT / 2)
 
 /* ================= FFT config ================= */
-#define FFT_SIZE               128
-#define FFT_SAMPLING_FREQUENCY 50
+// FFT_SIZE and the spectrum backend for each target live in Spectrum.h
+
+/* ================= Detector config ================= */
+// Let the sequential detector end a capture as soon as it is confident;
+// the FFT only runs when a full window passes without a decision
+#define SEQUENTIAL_DETECTION   1
+// Analyse captures with the 2-8 Hz zoom spectrum (ZoomSpectrum.h):
+// 0.39 Hz bins instead of 0.78 Hz, for 2.96 s frames instead of 1.28 s
+#define ZOOM_ANALYSIS          0
+// Minimum share of the >= 1 Hz spectral energy that must fall in the
+// band of the peak; rejects broadband jerks with an in-band maximum.
+// The zoom spectrum only sees 1-11.25 Hz instead of 1-25 Hz, which
+// lifts the ratios of white noise about 1.7x, so its gate is scaled
+// to reject the same share.
+#if ZOOM_ANALYSIS
+#define BAND_RATIO_MIN         0.17f
+#else
+#define BAND_RATIO_MIN         0.10f
+#endif
+
+#if ZOOM_ANALYSIS && FFT_SIZE < 2 * ZOOM_FFT_SIZE
+#error "The zoom frame is kept in vReal, which is too small"
+#endif
 
 #define ADXL_INT_PIN 1
 
 /* ================= Function Declarations/Prototypes ================= */
-void writeRegister(char reg, char value);
-byte readRegister(char reg);
 void isr_twitch();
 void TakeSample();
+void startCapture(uint8_t primingSamples = 0);
+bool addCaptureSample(float sample);
 float getMagnitude();
-float getPeakFrequency(float vReal[], int bins, float fs);
 void insertToBuffer(bool recent);
 bool detectDiskinesiaFromFFT(float peakFreq);
 bool detectTremorsFromFFT(float peakFreq);
 bool Tremor();
+uint8_t loggedPeakCode();
+void logDetectionChanges();
+void handleSerialCommand();
+void replayTrace();
+void applySequentialDecision(SequentialDecision decision);
 // REMOVED: void computeBandPercentagesFromFFT(...)
 
 /* ================= Globals ================= */
 float vReal[FFT_SIZE];
-float vImag[FFT_SIZE];
-
-ArduinoFFT<float> FFT(vReal, vImag, FFT_SIZE, FFT_SAMPLING_FREQUENCY);
 
 Adafruit_ADXL345_Unified accel = Adafruit_ADXL345_Unified(12345);
 
@@ -51,10 +81,12 @@ bool sampling = false;
 /* Output features */
 bool  diskinesia  = false;
 float peak_freq   = 0.0f;
+float peak_amp    = 0.0f;
+bool  early_decision = false;  // Last capture ended by the sequential detector
+float tremor_ratio     = 0.0f;
+float dyskinesia_ratio = 0.0f;
 
-unsigned long lastSampleTime = 0;
 int sampleIndex = 0;
-sensors_event_t event;
 
 bool TremorBuffer[3] = {false, false, false};
 int bufferPointer = 0;
@@ -80,10 +112,6 @@ bool touchActive = false;
 bool touchscreenAvailable = false;
 bool touchJustEnded = false;
 unsigned long lastTouchProcessTime = 0;
-bool tremorDataChanged = false;
-bool dyskinesiaDataChanged = false;
-bool newDataAvailable = false;
-SensorData sensorData = {0.0, false, false, 0};
 
 /* ===================================================== */
 void setup() {
@@ -92,181 +120,209 @@ void setup() {
     #endif
     Serial.begin(9600);
     delay(500);
-    Serial.println("Starting embedded challenge firmware...");
+    Serial.println(F("Starting embedded challenge firmware..."));
     
     initializeDisplay();
     initializeTouch();
     drawHomeScreen();
+    SensorData initialData;
+    readSensorSnapshot(initialData);
+    updateHomeScreenStats(initialData);
     
     if (!accel.begin()) {
     } else {
         accel.setRange(ADXL345_RANGE_2_G);
-        accel.setDataRate(ADXL345_DATARATE_50_HZ);
+        accel.setDataRate(ACQ_DATARATE);
+        acquisitionBegin();
         
         delay(500);
         
-        writeRegister(ADXL345_REG_THRESH_ACT, 30);
-        writeRegister(ADXL345_REG_ACT_INACT, 0x70);
-        writeRegister(ADXL345_REG_INT_MAP, 0x00);
-        writeRegister(ADXL345_REG_INT_ENABLE, 0x10);
+        accelWriteRegister(ADXL345_REG_THRESH_ACT, 30);
+        accelWriteRegister(ADXL345_REG_ACT_INACT, 0x70);
+        accelWriteRegister(ADXL345_REG_INT_MAP, 0x00);
+        accelWriteRegister(ADXL345_REG_INT_ENABLE, 0x10);
         
         pinMode(ADXL_INT_PIN, INPUT);
         attachInterrupt(digitalPinToInterrupt(ADXL_INT_PIN), isr_twitch, RISING);
         
-        readRegister(ADXL345_REG_INT_SOURCE);
+        accelReadRegister(ADXL345_REG_INT_SOURCE);
     }
-    for(int i = 0; i < FFT_SIZE; i++) vImag[i] = 0.0f;
+    eventLogBegin();
+#if ZOOM_ANALYSIS
+    // The full-band buffer is free in zoom mode; lend it to the zoom frame
+    zoomSpectrumBegin(vReal);
+#endif
 }
 
 /* ===================================================== */
 void loop() {
+    handleSerialCommand();
+    uint16_t overruns = acquisitionOverruns();
+    acquisitionPoll();
+    if (sampling && acquisitionOverruns() != overruns) {
+        // Samples were lost mid-capture; don't splice across the gap
+        Serial.println(F("FIFO overrun, capture restarted"));
+        startCapture();
+    }
+
     // if motion is detected from interrupt, sets off workflow
     if (motionDetected && !sampling) {
         motionDetected = false;
-        readRegister(ADXL345_REG_INT_SOURCE);
-        sampling = true;
-        lastSampleTime = millis();
+        accelReadRegister(ADXL345_REG_INT_SOURCE);
+        startCapture(acquisitionRewind(PRETRIGGER_SAMPLES));
     }
-    // gets 3 sec buffer after there is a movement
+    // collects one analysis window after a movement (1.28 s, or 2.96 s
+    // with ZOOM_ANALYSIS)
     if (sampling) {
-        unsigned long now = millis();
-        if (now - lastSampleTime >= SAMPLE_PERIOD_MS) {
-            vReal[sampleIndex] = getMagnitude();
-            vImag[sampleIndex] = 0.0f;
-            sampleIndex++;
-            lastSampleTime = now;
-            
-            if (sampleIndex >= SAMPLE_COUNT) {
+        float sample;
+        while (sampling && acquisitionRead(sample)) {
+            bool frameReady = addCaptureSample(sample);
+#if SEQUENTIAL_DETECTION
+            SequentialDecision decision = sequentialDetectorUpdate(sample);
+            if (decision != SEQ_UNDECIDED) {
+                applySequentialDecision(decision);
+                logDetectionChanges();
+                // The centre frequency isn't a measurement; clear the old peak
+                postUiEvent(UI_EVENT_NEW_SPECTRUM, UI_PEAK_NONE);
+                break;
+            }
+#endif
+            if (frameReady) {
                 TakeSample();
-                Serial.print("Peak Freq:");
+                logDetectionChanges();
+                postUiEvent(UI_EVENT_NEW_SPECTRUM, (int16_t)(peak_freq * 10.0f + 0.5f));
+                Serial.print(F("Peak Freq:"));
                 Serial.println(peak_freq);
             }
         }
     }
-    // updates the graph so it looks real-time
-    updateSensorData(getMagnitude(), Tremor(), diskinesia);
 
-    // Only update detection data when not sampling
-    if (!sampling) {
-        bool tremorDetected = Tremor();
-        bool dyskinesiaDetected = diskinesia;
-        
-        // SIMPLIFIED MAGNITUDE CALCULATION
-        // Use current acceleration magnitude as a simple value for the graph
-        float combinedMagnitude = getMagnitude();
-        
-        // Use max acceleration magnitude if needed, but for now, keep it minimal
-        if (combinedMagnitude > 10.0f) combinedMagnitude = 10.0f; // Cap for graph scale
-        
-        updateSensorData(combinedMagnitude, tremorDetected, dyskinesiaDetected);
-        newDataAvailable = true;
-
-        // Debug output removed percentages to match removal
-        // Serial.print("Magnitude: ");
-        // Serial.print(combinedMagnitude);
-        // Serial.print(" | Tremor: ");
-        // Serial.print(tremorDetected ? "YES" : "NO");
-        // Serial.print(" | Dyskinesia: ");
-        // Serial.println(dyskinesiaDetected ? "YES" : "NO");
-    }
+    // Detection state only changes when a capture ends, so it is safe to
+    // publish every loop; the UI is told about changes through events
+    bool tremorDetected = Tremor();
+    bool dyskinesiaDetected = diskinesia;
     
-    // UI handling (now using simple timer toggle)
-    if (newDataAvailable) {
-        checkSensorDataChanges();
-        newDataAvailable = false;
-    }
-    handleTouch(); // Now simple timer toggle
-    detectSwipe(); // Does nothing
+    // SIMPLIFIED MAGNITUDE CALCULATION
+    // Use current acceleration magnitude as a simple value for the graph
+    float combinedMagnitude = getMagnitude();
     
-    // Update current screen display
-    switch (currentScreen) {
-        case SCREEN_HOME:
-            // Only update stats if detection states changed
-            if (tremorDataChanged || dyskinesiaDataChanged) {
-                updateHomeScreenStats();
-            }
-            break;
-        case SCREEN_GRAPH:
-            if (!graphScreenDrawn) {
-                updateGraphScreen();  // Initial draw
-            } else if (newDataAvailable) {
-                updateGraphScreen();  // Update when new data arrives
-                newDataAvailable = false;
-            } else {
-                // For testing: update graph periodically even without new data
-                static unsigned long lastGraphUpdate = 0;
-                if (millis() - lastGraphUpdate > 100) {
-                    updateGraphScreen();
-                    lastGraphUpdate = millis();
-                }
-            }
-            break;
-    }
+    // Use max acceleration magnitude if needed, but for now, keep it minimal
+    if (combinedMagnitude > 10.0f) combinedMagnitude = 10.0f; // Cap for graph scale
+    
+    updateSensorData(combinedMagnitude, tremorDetected, dyskinesiaDetected);
+
+    // Debug output removed percentages to match removal
+    // Serial.print("Magnitude: ");
+    // Serial.print(combinedMagnitude);
+    // Serial.print(" | Tremor: ");
+    // Serial.print(tremorDetected ? "YES" : "NO");
+    // Serial.print(" | Dyskinesia: ");
+    // Serial.println(dyskinesiaDetected ? "YES" : "NO");
+    
+    // UI handling: touch posts events, then redraw only what changed
+    handleTouch();
+    detectSwipe(); // Does nothing
+    processUiEvents();
     
     delay(16);
 }
 
 /* ===================================================== */
 
+// primingSamples: rewound history at the head of the capture, which the
+// sequential detector only uses to settle its filters
+void startCapture(uint8_t primingSamples) {
+    sampling = true;
+    sampleIndex = 0;
+    sequentialDetectorReset(primingSamples);
+#if ZOOM_ANALYSIS
+    zoomSpectrumReset();
+#endif
+}
+
+// Stores one capture sample for the active analysis path; returns true
+// once there are enough samples for a spectrum
+bool addCaptureSample(float sample) {
+#if ZOOM_ANALYSIS
+    sampleIndex++;
+    return zoomSpectrumPush(sample);
+#else
+    vReal[sampleIndex++] = sample;
+    return sampleIndex >= SAMPLE_COUNT;
+#endif
+}
+
 // after samples array is filled, does fft calcs and checks for symptoms
 void TakeSample() {
     sampling = false;
     sampleIndex = 0;
-    FFT.windowing(FFT_WIN_TYP_HAMMING, FFT_FORWARD);
-    FFT.compute(FFT_FORWARD);
-    FFT.complexToMagnitude();
-    int mean = 0;
-    for(int i = 0; i < FFT_SIZE; i++) {
-        mean += vReal[i];
-    }
-    mean /= FFT_SIZE;
-    for(int i = 0; i < FFT_SIZE; i++) {
-        vReal[i] -= (3*mean/4);
-        
-    }
-    peak_freq = getPeakFrequency(vReal, FFT_SIZE / 2,
-                                 FFT_SAMPLING_FREQUENCY);
+#if ZOOM_ANALYSIS
+    SpectrumFeatures features;
+    zoomSpectrumAnalyse(features);
+    zoomSpectrumReset();
+    peak_freq = features.peakFreq;
+    peak_amp = features.peakAmp;
+    tremor_ratio = features.tremorRatio;
+    dyskinesia_ratio = features.dyskinesiaRatio;
+#else
+    computeMagnitudeSpectrum(vReal);
+    SpectrumFeatures features;
+    extractSpectrumFeatures(vReal, FFT_SIZE / 2, 0.0f, FFT_BIN_HZ,
+                            FFT_BIN_HZ, FFT_SAMPLING_FREQUENCY / 2.0f,
+                            spectrumFloor(vReal, FFT_SIZE), features);
+    peak_freq = features.peakFreq;
+    peak_amp = features.peakAmp;
+    tremor_ratio = features.tremorRatio;
+    dyskinesia_ratio = features.dyskinesiaRatio;
+    Serial.print(F("maxAmp: "));
+    Serial.println(peak_amp);
+#endif
+    early_decision = false;
     diskinesia = detectDiskinesiaFromFFT(peak_freq);
     insertToBuffer(detectTremorsFromFFT(peak_freq));
-    
 }
 
-/* ================= Feature functions ================= */
+// Ends the capture early with the sequential detector's verdict.
+// A tremor decision carries the confidence of three FFT windows in a row.
+void applySequentialDecision(SequentialDecision decision) {
+    Serial.print(F("Early decision after "));
+    Serial.print(sampleIndex);
+    Serial.print(F(" samples: "));
+    Serial.println(decision);
 
-float getPeakFrequency(float vReal[], int bins, float fs){
-    float maxAmp = 0.0f;
-    float peakFreq = 0.0f;
-    
-    for (int i = 1; i < bins; i++) {
-        float freq = (i * fs) / FFT_SIZE;
-        if (freq<0.4 ){
-            vReal[i]+=5;
-        }
-        if (3<freq && freq<5 ){
-            vReal[i]*=1.15;
-        }
-        if (5<freq && freq<7 ){
-            vReal[i]*=0.95;
-        }
-        if (vReal[i] > maxAmp) {
-            maxAmp = vReal[i];
-            peakFreq = freq;
-        }
+    sampling = false;
+    sampleIndex = 0;
+    // No spectrum behind this decision, so no peak to report
+    early_decision = true;
+    peak_freq = 0.0f;
+    peak_amp = 0.0f;
+    switch (decision) {
+        case SEQ_TREMOR:
+            for (int i = 0; i < 3; i++) TremorBuffer[i] = true;
+            diskinesia = false;
+            break;
+        case SEQ_DYSKINESIA:
+            insertToBuffer(false);
+            diskinesia = true;
+            break;
+        default:
+            insertToBuffer(false);
+            diskinesia = false;
+            break;
     }
-    Serial.print("maxAmp: ");
-    Serial.println(maxAmp);
-    return peakFreq;
-    
 }
 
+/* ================= Feature functions ================= */
+
+
 // detects the diskenesia range
 bool detectDiskinesiaFromFFT(float peakFreq) {
-    return (peakFreq >= 5.0f && peakFreq <= 7.0f);
+    return (peakFreq >= 5.0f && peakFreq < 7.0f) && dyskinesia_ratio >= BAND_RATIO_MIN;
 }
 
 // detects the tremor range
 bool detectTremorsFromFFT(float peakFreq){
-    return (peakFreq >= 3.0f && peakFreq <= 5.0f);
+    return (peakFreq >= 3.0f && peakFreq < 5.0f) && tremor_ratio >= BAND_RATIO_MIN;
 }
 
 // There is a buffer so that tremors only show up when 3 Tremor ranges occur in a row
@@ -287,39 +343,136 @@ bool Tremor(){
     return true;
 }
 
+/* ================= Event log ================= */
+// Peak for the log: measured frequency, or the early decision marker
+uint8_t loggedPeakCode() {
+    return early_decision ? EVENTLOG_FREQ_EARLY : eventLogEncodeFrequency(peak_freq);
+}
+
+// Records rising edges of tremor/dyskinesia and the return to normal
+void logDetectionChanges() {
+    static bool loggedTremor = false;
+    static bool loggedDyskinesia = false;
+    bool tremor = Tremor();
 
-/* ================= I2C helpers ================= */
-// used to set register settings
-void writeRegister(char reg, char value) {
-    Wire.beginTransmission(0x53);
-    Wire.write(reg);
-    Wire.write(value);
-    Wire.endTransmission();
+    if (tremor && !loggedTremor) {
+        eventLogAppend(EVENT_TREMOR, loggedPeakCode(), peak_amp);
+        lastTremorTime = millis();
+    }
+    if (diskinesia && !loggedDyskinesia) {
+        eventLogAppend(EVENT_DYSKINESIA, loggedPeakCode(), peak_amp);
+        lastDyskinesiaTime = millis();
+    }
+    if (!tremor && !diskinesia && (loggedTremor || loggedDyskinesia)) {
+        eventLogAppend(EVENT_CLEAR, loggedPeakCode(), peak_amp);
+    }
+    loggedTremor = tremor;
+    loggedDyskinesia = diskinesia;
 }
 
-// used when reading interrupt
-byte readRegister(char reg) {
-    Wire.beginTransmission(0x53);
-    Wire.write(reg);
-    Wire.endTransmission();
-    Wire.requestFrom(0x53, 1);
-    return Wire.read();
+// Single-byte serial commands: 'D' dumps the event log, 'E' erases it,
+// 'R' replays a recorded trace (see replayTrace), 'B' benchmarks the FFT
+void handleSerialCommand() {
+    if (!Serial.available()) return;
+    switch (Serial.read()) {
+        case 'D':
+            eventLogDump(Serial);
+            break;
+        case 'E':
+            eventLogErase();
+            Serial.println(F("Event log erased"));
+            break;
+        case 'R':
+            replayTrace();
+            break;
+        case 'B':
+            // Uses vReal as scratch, so drop any capture in progress.
+            // Only the path this build analyses with is linked in, so
+            // compare zoom and full-band by benchmarking both builds.
+            sampling = false;
+            sampleIndex = 0;
+            Serial.print(F("BENCH,"));
+#if ZOOM_ANALYSIS
+            // Zoom frames include the streaming mix/FIR work per sample
+            Serial.print(F(SPECTRUM_BACKEND "-zoom"));
+            Serial.print(',');
+            Serial.print(ZOOM_FFT_SIZE);
+            Serial.print(',');
+            Serial.println(benchmarkZoomSpectrum(20));
+#else
+            Serial.print(F(SPECTRUM_BACKEND));
+            Serial.print(',');
+            Serial.print(FFT_SIZE);
+            Serial.print(',');
+            Serial.println(benchmarkSpectrum(vReal, 20));
+#endif
+            Serial.println(F("BENCH,END"));
+            break;
+    }
+}
+
+/* ================= Trace replay ================= */
+// Runs a recorded trace through the same FFT and detector as live data,
+// used by tools/replay_trace.py to validate detector changes offline.
+// Frame after 'R': uint16 sample count, then int16 samples of the
+// gravity-removed magnitude in 0.01 m/s^2 at FFT_SAMPLING_FREQUENCY.
+// Replayed detections are not written to the event log. Sequential
+// detector decisions are reported as "SEQ,<sample>,<decision>" lines.
+void replayTrace() {
+    uint8_t raw[2];
+    if (Serial.readBytes(raw, 2) != 2) return;
+    uint16_t count = raw[0] | (raw[1] << 8);
+
+    startCapture();
+    sampling = false;  // Keep loop() from consuming live samples meanwhile
+    for (int i = 0; i < 3; i++) TremorBuffer[i] = false;
+
+    for (uint16_t n = 0; n < count; n++) {
+        if (Serial.readBytes(raw, 2) != 2) break;
+        float sample = (int16_t)(raw[0] | (raw[1] << 8)) / 100.0f;
+        SequentialDecision decision = sequentialDetectorUpdate(sample);
+        if (decision != SEQ_UNDECIDED) {
+            Serial.print(F("SEQ,"));
+            Serial.print(n);
+            Serial.print(',');
+            Serial.println(decision);
+            sequentialDetectorReset();
+        }
+        if (addCaptureSample(sample)) {
+            TakeSample();
+            Serial.print(F("REPLAY,"));
+            Serial.print(peak_freq);
+            Serial.print(',');
+            Serial.print(tremor_ratio);
+            Serial.print(',');
+            Serial.print(dyskinesia_ratio);
+            Serial.print(',');
+            Serial.print(detectTremorsFromFFT(peak_freq));  // Per window
+            Serial.print(',');
+            Serial.println(diskinesia);
+        }
+    }
+
+    // Leave the live detector as if nothing had been seen
+    sampleIndex = 0;
+    diskinesia = false;
+    for (int i = 0; i < 3; i++) TremorBuffer[i] = false;
+    Serial.println(F("REPLAY,END"));
 }
 
-// Gets magnitude of acceleration reading.
+/* ================= Sensor helpers ================= */
+// ADXL345 register access lives in Acquisition.cpp
+
+// Gets magnitude of the latest acceleration reading.
+// Reads from the acquisition layer: touching the data registers directly
+// would pop samples out of the FIFO.
 float getMagnitude(){
-    accel.getEvent(&event);
-    
-    float x = event.acceleration.x;
-    float y = event.acceleration.y;
-    float z = event.acceleration.z;
-    // Serial.print("X: "); Serial.print(x); Serial.print("\tY: "); Serial.print(y); Serial.print("\tZ: "); Serial.println(z);
-    return sqrt(x*x + y*y + z*z) - 9.802f;
+    return acquisitionLatest();
 }
 
 /* ================= ISR ================= */
 // goes off if a small shake occurs occurs
 void isr_twitch() {
     motionDetected = true;
-    Serial.println("Motion detected (ISR)");
+    Serial.println(F("Motion detected (ISR)"));
 }
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef ADAFRUIT_ADXL345_SHIM_H
+#define ADAFRUIT_ADXL345_SHIM_H
+
+// Constants Acquisition.h refers to, for the native test build
+
+#define ADXL345_DEFAULT_ADDRESS (0x53)
+
+typedef enum {
+    ADXL345_DATARATE_200_HZ = 0b1011,
+    ADXL345_DATARATE_50_HZ = 0b1001,
+} dataRate_t;
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef ARDUINO_SHIM_H
+#define ARDUINO_SHIM_H
+
+// Just enough of the Arduino API for the native (host) test build
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline unsigned long micros() {
+    return (unsigned long)(clock() * (1000000.0 / CLOCKS_PER_SEC));
+}
+
+#endif
@@ -0,0 +1,65 @@
+#include <unity.h>
+#include "SequentialDetector.h"
+
+#define HISTORY_SAMPLES 28   // Pre-trigger history handed to the detector
+#define CAPTURE_SAMPLES 64
+
+void setUp() {}
+void tearDown() {}
+
+// Fixed LCG so the noise is the same on every run
+static uint32_t seed = 1;
+static float noise(float amplitude) {
+    seed = seed * 1664525u + 1013904223u;
+    return ((seed >> 8) / 16777216.0f - 0.5f) * 2.0f * amplitude;
+}
+
+// Quiet history, then a tone from the trigger on. Returns the first
+// decision and the sample (counted from the trigger) it came at.
+static SequentialDecision runCapture(float amplitude, float freq, float phase, int &at) {
+    sequentialDetectorReset(HISTORY_SAMPLES);
+    for (int i = 0; i < HISTORY_SAMPLES + CAPTURE_SAMPLES; i++) {
+        float x = noise(0.03f);
+        if (i >= HISTORY_SAMPLES) {
+            x += amplitude * sin(2.0f * PI * freq * (i - HISTORY_SAMPLES) / SEQ_SAMPLE_RATE_HZ + phase);
+        }
+        SequentialDecision decision = sequentialDetectorUpdate(x);
+        if (decision != SEQ_UNDECIDED) {
+            at = i - HISTORY_SAMPLES;
+            return decision;
+        }
+    }
+    at = -1;
+    return SEQ_UNDECIDED;
+}
+
+// The quiet history must not count as evidence against a tremor that
+// starts at the trigger
+static void test_quiet_history_then_tremor() {
+    for (int p = 0; p < 8; p++) {
+        int at;
+        TEST_ASSERT_EQUAL(SEQ_TREMOR, runCapture(0.5f, 4.2f, p * 0.8f, at));
+        TEST_ASSERT_TRUE(at >= 0);
+    }
+}
+
+static void test_quiet_history_then_dyskinesia() {
+    for (int p = 0; p < 8; p++) {
+        int at;
+        TEST_ASSERT_EQUAL(SEQ_DYSKINESIA, runCapture(0.5f, 6.0f, p * 0.8f, at));
+    }
+}
+
+static void test_quiet_throughout_is_clear() {
+    int at;
+    TEST_ASSERT_EQUAL(SEQ_CLEAR, runCapture(0.0f, 4.0f, 0.0f, at));
+    TEST_ASSERT_TRUE(at >= 0);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_quiet_history_then_tremor);
+    RUN_TEST(test_quiet_history_then_dyskinesia);
+    RUN_TEST(test_quiet_throughout_is_clear);
+    return UNITY_END();
+}
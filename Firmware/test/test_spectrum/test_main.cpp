@@ -0,0 +1,64 @@
+#include <unity.h>
+#include "Spectrum.h"
+
+static float samples[FFT_SIZE];
+
+void setUp() {}
+void tearDown() {}
+
+static SpectrumFeatures analyseTone(float freq, float phase, float noise) {
+    // Fixed LCG so the noise is the same on every run
+    static uint32_t seed = 1;
+    for (int i = 0; i < FFT_SIZE; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float n = ((seed >> 8) / 16777216.0f - 0.5f) * 2.0f * noise;
+        samples[i] = sin(2.0f * PI * freq * i / FFT_SAMPLING_FREQUENCY + phase) + n;
+    }
+    computeMagnitudeSpectrum(samples);
+    SpectrumFeatures features;
+    extractSpectrumFeatures(samples, FFT_SIZE / 2, 0.0f, FFT_BIN_HZ,
+                            FFT_BIN_HZ, FFT_SAMPLING_FREQUENCY / 2.0f,
+                            spectrumFloor(samples, FFT_SIZE), features);
+    return features;
+}
+
+// The band weights step at 5 Hz; they must not drag the interpolated
+// peak across it
+static void test_peak_near_band_edge() {
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 4.9f, analyseTone(4.9f, 0.0f, 0.0f).peakFreq);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 5.0f, analyseTone(5.0f, 0.0f, 0.0f).peakFreq);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 5.2f, analyseTone(5.2f, 0.0f, 0.0f).peakFreq);
+}
+
+static void test_peak_sweep_2_to_8_hz() {
+    float sum = 0.0f;
+    float worst = 0.0f;
+    int count = 0;
+    for (float f = 2.0f; f <= 8.0f; f += 0.05f) {
+        for (int p = 0; p < 4; p++) {
+            float error = fabs(analyseTone(f, p * 0.7f, 0.2f).peakFreq - f);
+            sum += error;
+            if (error > worst) worst = error;
+            count++;
+        }
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(0.03f, sum / count);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.15f, worst);
+}
+
+static void test_band_ratios_are_half_open() {
+    SpectrumFeatures f = analyseTone(4.0f, 0.0f, 0.0f);
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.5f, f.tremorRatio);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f, f.dyskinesiaRatio);
+    f = analyseTone(6.0f, 0.0f, 0.0f);
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.5f, f.dyskinesiaRatio);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f, f.tremorRatio);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_peak_near_band_edge);
+    RUN_TEST(test_peak_sweep_2_to_8_hz);
+    RUN_TEST(test_band_ratios_are_half_open);
+    return UNITY_END();
+}
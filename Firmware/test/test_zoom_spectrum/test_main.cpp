@@ -0,0 +1,43 @@
+#include <unity.h>
+#include "ZoomSpectrum.h"
+
+static float storage[2 * ZOOM_FFT_SIZE];
+
+void setUp() {
+    zoomSpectrumBegin(storage);
+}
+void tearDown() {}
+
+static SpectrumFeatures analyseTone(float freq, float phase) {
+    zoomSpectrumReset();
+    for (int i = 0; !zoomSpectrumPush(sin(2.0f * PI * freq * i / FFT_SAMPLING_FREQUENCY + phase)); i++) {
+    }
+    SpectrumFeatures features;
+    zoomSpectrumAnalyse(features);
+    return features;
+}
+
+// Bin 16 sits exactly on 5 Hz; it must count in one band only
+static void test_band_edge_counted_once() {
+    SpectrumFeatures f = analyseTone(5.0f, 0.0f);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 5.0f, f.peakFreq);
+    TEST_ASSERT_LESS_THAN_FLOAT(1.0001f, f.tremorRatio + f.dyskinesiaRatio);
+}
+
+static void test_peak_sweep_3_to_7_hz() {
+    float worst = 0.0f;
+    for (float f = 3.0f; f <= 7.0f; f += 0.05f) {
+        for (int p = 0; p < 4; p++) {
+            float error = fabs(analyseTone(f, p * 0.7f).peakFreq - f);
+            if (error > worst) worst = error;
+        }
+    }
+    TEST_ASSERT_LESS_THAN_FLOAT(0.1f, worst);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_band_edge_counted_once);
+    RUN_TEST(test_peak_sweep_3_to_7_hz);
+    return UNITY_END();
+}
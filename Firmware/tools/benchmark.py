@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""Compare per-frame spectrum cost across boards.
+
+Sends the 'B' serial command to each board, which times the spectrum
+backend of its build (ArduinoFFT on the 32u4, CMSIS-DSP on the Feather
+M4) on the same synthetic frame, and prints the speedup against the
+first row. A build times whichever spectrum it analyses with (full-band,
+or zoom with ZOOM_ANALYSIS), so flash both to compare them.
+
+Usage:
+    benchmark.py /dev/ttyACM0 /dev/ttyACM1
+"""
+
+import sys
+
+
+def run(port):
+    import serial  # pyserial
+
+    rows = []
+    with serial.Serial(port, 9600, timeout=5) as ser:
+        ser.reset_input_buffer()
+        ser.write(b"B")
+        while True:
+            line = ser.readline().decode(errors="replace").strip()
+            if not line:
+                sys.exit("%s: no benchmark reply" % port)
+            if line == "BENCH,END":
+                return rows
+            if line.startswith("BENCH,"):
+                _, backend, size, micros = line.split(",")
+                rows.append((port, backend, int(size), int(micros)))
+
+
+def main():
+    ports = sys.argv[1:]
+    if not ports:
+        sys.exit(__doc__)
+
+    results = [row for port in ports for row in run(port)]
+    baseline = results[0][3]
+    print("%-16s %-15s %5s %10s %8s" % ("port", "backend", "size", "us/frame", "speedup"))
+    for port, backend, size, micros in results:
+        print("%-16s %-15s %5d %10d %7.1fx" % (port, backend, size, micros,
+                                                     baseline / max(micros, 1)))
+
+
+if __name__ == "__main__":
+    main()
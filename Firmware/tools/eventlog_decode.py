@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Fetch and decode the on-device episode log (see include/EventLog.h).
+
+Usage:
+    eventlog_decode.py --port /dev/ttyACM0      # send 'D' and decode the reply
+    eventlog_decode.py --file dump.bin          # decode a saved dump
+    eventlog_decode.py --port ... --save dump.bin
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"ELOG"
+HEADER = struct.Struct("<4sBBHH")
+SEQ_ERASED = 0xFF
+NO_HEAD = 0xFFFF
+TYPES = {0: "BOOT", 1: "TREMOR", 2: "DYSKINESIA", 3: "CLEAR"}
+FREQ_STEP_HZ = 0.25
+FREQ_NONE = 0
+FREQ_EARLY = 63  # Sequential detector decided before any spectrum
+
+
+def read_from_port(port, timeout):
+    import serial  # pyserial
+
+    with serial.Serial(port, 9600, timeout=timeout) as ser:
+        ser.reset_input_buffer()
+        ser.write(b"D")
+        # Skip any text lines printed before the frame
+        data = b""
+        while MAGIC not in data:
+            byte = ser.read(1)
+            if not byte:
+                sys.exit("no event log frame received")
+            data = (data + byte)[-len(MAGIC):]
+        rest = ser.read(HEADER.size - len(MAGIC))
+        _, _, record_size, slots, _ = HEADER.unpack(MAGIC + rest)
+        body = ser.read(record_size * slots + 2)
+        return MAGIC + rest + body
+
+
+def decode_amplitude(code):
+    return 2.0 ** (code / 16.0) - 1.0
+
+
+def format_peak(rec):
+    """Peak column: Hz, "none", "early" for sequential detector decisions,
+    or the raw FFT bin for version 1 records (their bin width depended on
+    the firmware's FFT size)."""
+    if rec["format"] == 1:
+        return "bin %d" % rec["code"]
+    if rec["format"] is None:
+        return "code %d" % rec["code"]
+    if rec["code"] == FREQ_NONE:
+        return "none"
+    if rec["code"] == FREQ_EARLY:
+        return "early"
+    return "%.2f" % (rec["code"] * FREQ_STEP_HZ)
+
+
+def decode(frame):
+    start = frame.find(MAGIC)
+    if start < 0:
+        sys.exit("not an event log dump")
+    magic, version, record_size, slots, head = HEADER.unpack_from(frame, start)
+    if version not in (1, 2) or record_size != 5:
+        sys.exit("unsupported dump version %d / record size %d" % (version, record_size))
+
+    raw = frame[start + HEADER.size:start + HEADER.size + record_size * slots]
+    checksum, = struct.unpack_from("<H", frame, start + HEADER.size + len(raw))
+    if sum(raw) & 0xFFFF != checksum:
+        sys.exit("checksum mismatch, dump is corrupt")
+    if head == NO_HEAD:
+        return []
+
+    # Oldest record is the one after the head; walk the ring forward
+    records = []
+    for i in range(1, slots + 1):
+        slot = (head + i) % slots
+        rec = raw[slot * record_size:(slot + 1) * record_size]
+        if rec[0] == SEQ_ERASED:
+            continue
+        records.append({
+            "seq": rec[0],
+            "type": TYPES[rec[1] >> 6],
+            "code": rec[1] & 0x3F,
+            "amp_code": rec[2],
+            "amplitude": decode_amplitude(rec[2]),
+            "delta_s": rec[3] | (rec[4] << 8),
+        })
+
+    # Timestamps are deltas; each BOOT record restarts the clock. A BOOT
+    # record's amplitude byte holds the record format of the entries after
+    # it (0 from version 1 firmware). Records older than the oldest
+    # surviving BOOT have an unknown format unless the dump predates
+    # version 2 or a later boot still ran version 1 firmware.
+    later_legacy_boot = any(r["type"] == "BOOT" and r["amp_code"] == 0 for r in records)
+    fmt = 1 if version == 1 or later_legacy_boot else None
+    boot = -1
+    elapsed = 0
+    for rec in records:
+        if rec["type"] == "BOOT":
+            boot += 1
+            elapsed = 0
+            fmt = rec["amp_code"] or 1
+            rec["amplitude"] = 0.0
+        else:
+            elapsed += rec["delta_s"]
+        rec["boot"] = boot
+        rec["time_s"] = elapsed
+        rec["format"] = fmt
+    return records
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port", help="serial port of the device")
+    src.add_argument("--file", help="previously saved binary dump")
+    parser.add_argument("--save", help="also write the raw dump to this file")
+    parser.add_argument("--timeout", type=float, default=3.0)
+    args = parser.parse_args()
+
+    if args.port:
+        frame = read_from_port(args.port, args.timeout)
+    else:
+        with open(args.file, "rb") as f:
+            frame = f.read()
+    if args.save:
+        with open(args.save, "wb") as f:
+            f.write(frame)
+
+    print("boot,time_s,seq,type,peak_hz,amplitude")
+    for rec in decode(frame):
+        print("%d,%d,%d,%s,%s,%.1f" % (rec["boot"], rec["time_s"], rec["seq"],
+                                       rec["type"], format_peak(rec), rec["amplitude"]))
+
+
+if __name__ == "__main__":
+    main()
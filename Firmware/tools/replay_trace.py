@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Replay a recorded 50 Hz trace through the on-device detector.
+
+The trace is a CSV with one sample per line: the gravity-removed
+acceleration magnitude in m/s^2, optionally followed by a label
+(none / tremor / dyskinesia) for that sample. With labels, each analysis
+window is scored against the majority label of its samples, so builds
+with different FFT_SIZE or detector settings can be compared on the
+same recordings. Early decisions of the sequential detector are listed
+with the sample at which they were made.
+
+Usage:
+    replay_trace.py --port /dev/ttyACM0 trace.csv [more.csv ...]
+"""
+
+import argparse
+import collections
+import struct
+import sys
+
+# SequentialDecision values from include/SequentialDetector.h
+SEQ_DECISIONS = {"1": "tremor", "2": "dyskinesia", "3": "none"}
+
+
+def load_trace(path):
+    samples, labels = [], []
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            fields = line.split(",")
+            try:
+                samples.append(float(fields[0]))
+            except ValueError:
+                continue  # header row
+            labels.append(fields[1].strip().lower() if len(fields) > 1 else None)
+    return samples, labels
+
+
+def replay(ser, samples):
+    payload = b"".join(struct.pack("<h", max(-32768, min(32767, round(s * 100))))
+                       for s in samples)
+    ser.reset_input_buffer()
+    ser.write(b"R" + struct.pack("<H", len(samples)) + payload)
+
+    windows, early = [], []
+    while True:
+        line = ser.readline().decode(errors="replace").strip()
+        if not line:
+            sys.exit("device stopped responding")
+        if line.startswith("SEQ,"):
+            _, sample, decision = line.split(",")
+            early.append((int(sample), SEQ_DECISIONS.get(decision, decision)))
+            continue
+        if not line.startswith("REPLAY,"):
+            continue  # debug prints from the detector
+        fields = line.split(",")[1:]
+        if fields[0] == "END":
+            return windows, early
+        peak, tremor_ratio, dysk_ratio, tremor, dysk = fields
+        windows.append({
+            "peak": float(peak),
+            "tremor_ratio": float(tremor_ratio),
+            "dyskinesia_ratio": float(dysk_ratio),
+            # Per-window decision; live alerts also need three tremor
+            # windows in a row
+            "tremor": tremor == "1",
+            "dyskinesia": dysk == "1",
+        })
+
+
+def predicted(window):
+    if window["tremor"]:
+        return "tremor"
+    if window["dyskinesia"]:
+        return "dyskinesia"
+    return "none"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", required=True)
+    parser.add_argument("--window", type=int, default=64,
+                        help="samples per analysis window (FFT_SIZE of the build)")
+    parser.add_argument("traces", nargs="+")
+    args = parser.parse_args()
+
+    import serial  # pyserial
+
+    correct = total = 0
+    with serial.Serial(args.port, 9600, timeout=5) as ser:
+        for path in args.traces:
+            samples, labels = load_trace(path)
+            windows, early = replay(ser, samples)
+            window_len = args.window
+            print("%s: %d samples, %d windows of %d" % (path, len(samples), len(windows), window_len))
+            for i, w in enumerate(windows):
+                line = "  %3d peak=%5.2f Hz  tremor=%.2f  dysk=%.2f  -> %s" % (
+                    i, w["peak"], w["tremor_ratio"], w["dyskinesia_ratio"], predicted(w))
+                window_labels = [l for l in labels[i * window_len:(i + 1) * window_len] if l]
+                if window_labels:
+                    expected = collections.Counter(window_labels).most_common(1)[0][0]
+                    total += 1
+                    if predicted(w) == expected:
+                        correct += 1
+                    line += "  (expected %s)" % expected
+                print(line)
+            for sample, decision in early:
+                print("  early: %s at sample %d (%.2f s)" % (decision, sample, sample / 50.0))
+
+    if total:
+        print("window accuracy: %d/%d = %.1f%%" % (correct, total, 100.0 * correct / total))
+
+
+if __name__ == "__main__":
+    main()